@@ -2,6 +2,7 @@
 #include <vector>
 #include <algorithm>
 #include <numeric>
+#include "pipeline.h"
 
 int main() {
     std::vector<int> numbers = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
@@ -28,5 +29,17 @@ int main() {
     for (int n : squares) std::cout << n << " ";
     std::cout << "\nSum: " << sum << std::endl;
     
+    // Same results through the parallel pipeline
+    auto parallelEvens = parallel_filter(numbers, [](int n) { return n % 2 == 0; });
+    auto evenSquares = parallel_pipeline(numbers,
+                                         [](int n) { return n % 2 == 0; },
+                                         [](int n) { return n * n; }, 0);
+    
+    std::cout << "\nParallel evens: ";
+    for (int n : parallelEvens) std::cout << n << " ";
+    std::cout << "\nSquares of evens: ";
+    for (int n : evenSquares.values) std::cout << n << " ";
+    std::cout << "\nSum of squares of evens: " << evenSquares.total << std::endl;
+    
     return 0;
 }
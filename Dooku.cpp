@@ -1,39 +1,6 @@
 #include <iostream>
-#include <vector>
 #include <utility>
-
-class Buffer {
-private:
-    int* data;
-    size_t size;
-    
-public:
-    Buffer(size_t s) : size(s) {
-        data = new int[size];
-        std::cout << "Constructor\n";
-    }
-    
-    ~Buffer() {
-        delete[] data;
-        std::cout << "Destructor\n";
-    }
-    
-    // Copy constructor
-    Buffer(const Buffer& other) : size(other.size) {
-        data = new int[size];
-        std::copy(other.data, other.data + size, data);
-        std::cout << "Copy constructor\n";
-    }
-    
-    // Move constructor
-    Buffer(Buffer&& other) noexcept : data(nullptr), size(0) {
-        data = other.data;
-        size = other.size;
-        other.data = nullptr;
-        other.size = 0;
-        std::cout << "Move constructor\n";
-    }
-};
+#include "buffer.h"
 
 template<typename T>
 void processBuffer(T&& buffer) {
@@ -42,9 +9,39 @@ void processBuffer(T&& buffer) {
 }
 
 int main() {
+    BufferPool& pool = BufferPool::instance();
+    
     Buffer buf1(10);
-    processBuffer(buf1);  // Lvalue: copy
+    processBuffer(buf1);  // Lvalue: shares storage, no copy
     processBuffer(Buffer(5));  // Rvalue: move
     
+    // Slices share storage until someone writes
+    int* raw = buf1.mutableData();
+    for(int i = 0; i < 10; ++i)
+        raw[i] = i;
+    
+    Buffer view = buf1.slice(2, 5);
+    std::cout << "Slice: ";
+    for(int v : view) std::cout << v << " ";
+    std::cout << "(shared: " << view.shared() << ")\n";
+    
+    view.mutableData()[0] = 99;  // Copy-on-write: only the view's 5 ints
+    std::cout << "After write: view[0] = " << view[0]
+              << ", buf1[2] = " << buf1[2] << "\n";
+    
+    // Large buffers come from their own huge-page mapping
+    {
+        Buffer big(64 * 1024 * 1024);
+        int* out = big.mutableData();
+        for(size_t i = 0; i < big.size(); i += 1024)
+            out[i] = 1;
+        std::cout << "Large buffer: " << big.size() * sizeof(int) / (1024 * 1024) << " MiB\n";
+    }
+    
+    auto before = pool.snapshot();
+    std::cout << "Pool: " << before.allocations << " allocations, "
+              << before.reuses << " reuses, " << before.bytesCopied << " bytes copied, "
+              << before.freed << " freed past the cache cap\n";
+    
     return 0;
 }
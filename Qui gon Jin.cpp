@@ -1,7 +1,9 @@
 #include <iostream>
 #include <variant>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "compact_value.h"
 
 // Visitor pattern with std::variant
 struct Visitor {
@@ -18,10 +20,6 @@ struct Visitor {
     }
 };
 
-// Alternative using overload pattern
-template<class... Ts> struct overload : Ts... { using Ts::operator()...; };
-template<class... Ts> overload(Ts...) -> overload<Ts...>;
-
 int main() {
     std::vector<std::variant<int, double, std::string>> values;
     
@@ -43,5 +41,22 @@ int main() {
         }, v);
     }
     
+    // Same ergonomics with the compact representation
+    StringArena arena;
+    std::vector<CompactValue> compact;
+    compact.emplace_back(42);
+    compact.emplace_back(3.14);
+    compact.emplace_back("Hello, Variant!", arena);
+    compact.emplace_back("A string too long to be stored inline", arena);
+    
+    std::cout << "\nUsing compact values (" << sizeof(CompactValue) << " bytes each):\n";
+    for (const auto& v : compact) {
+        visit(overload{
+            [](int i) { std::cout << "int: " << i << std::endl; },
+            [](double d) { std::cout << "double: " << d << std::endl; },
+            [](std::string_view s) { std::cout << "string: " << s << std::endl; }
+        }, v, arena);
+    }
+    
     return 0;
 }
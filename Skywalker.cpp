@@ -1,57 +1,6 @@
 #include <iostream>
 #include <vector>
-#include <cstdint>
-
-class MemoryPool {
-private:
-    struct Block {
-        Block* next;
-    };
-    
-    Block* freeList;
-    char* pool;
-    size_t blockSize;
-    size_t poolSize;
-    
-public:
-    MemoryPool(size_t blockSize, size_t numBlocks) 
-        : blockSize(blockSize), poolSize(blockSize * numBlocks) {
-        
-        pool = new char[poolSize];
-        freeList = reinterpret_cast<Block*>(pool);
-        
-        Block* current = freeList;
-        for(size_t i = 0; i < numBlocks - 1; ++i) {
-            Block* next = reinterpret_cast<Block*>(
-                pool + (i + 1) * blockSize
-            );
-            current->next = next;
-            current = next;
-        }
-        current->next = nullptr;
-    }
-    
-    void* allocate() {
-        if(freeList == nullptr)
-            throw std::bad_alloc();
-            
-        Block* block = freeList;
-        freeList = freeList->next;
-        return block;
-    }
-    
-    void deallocate(void* ptr) {
-        if(ptr == nullptr) return;
-        
-        Block* block = static_cast<Block*>(ptr);
-        block->next = freeList;
-        freeList = block;
-    }
-    
-    ~MemoryPool() {
-        delete[] pool;
-    }
-};
+#include "memory_pool.h"
 
 struct Point {
     int x, y, z;
@@ -81,5 +30,21 @@ int main() {
         pool.deallocate(p);
     }
     
+    // Handle-based store: dense storage and use-after-free detection
+    ObjectStore<Point> store(10);
+    std::vector<Handle> handles;
+    for(int i = 0; i < 5; ++i)
+        handles.push_back(store.create(i, i * 2, i * 3));
+    
+    store.erase(handles[1]);
+    Handle reused = store.create(7, 7, 7);
+    
+    std::cout << "\nStore after erase/create (" << store.size() << " live):\n";
+    store.for_each([](const Point& p) {
+        std::cout << "Point: (" << p.x << ", " << p.y << ", " << p.z << ")\n";
+    });
+    std::cout << "Stale handle valid: " << store.valid(handles[1])
+              << ", reused slot valid: " << store.valid(reused) << "\n";
+    
     return 0;
 }
@@ -0,0 +1,122 @@
+#include "harness.h"
+#include "vector_expr.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+namespace {
+
+long pageFaults() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt + usage.ru_majflt;
+}
+
+double randomReads(const Vector& v, size_t reads) {
+    double sum = 0;
+    uint64_t x = 88172645463325252ull;
+    for(size_t i = 0; i < reads; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        sum += v[x % v.size()];
+    }
+    return sum;
+}
+
+size_t vectorBytes() {
+    const char* env = std::getenv("BENCH_BACKING_MIB");
+    return (env ? std::strtoul(env, nullptr, 10) : 256) * 1024 * 1024;
+}
+
+}
+
+// Startup (allocate + first write of every element), page faults and
+// random-read throughput for each backing
+BENCH(backing) {
+    const size_t n = vectorBytes() / sizeof(double);
+    constexpr size_t reads = 2'000'000;
+    
+    struct Mode {
+        const char* name;
+        BackingOptions options;
+    };
+    const Mode modes[] = {
+        {"heap", {}},
+        {"mmap", {BackingOptions::Mapped}},
+        {"mmap_thp", {BackingOptions::Mapped, BackingOptions::TransparentHugePages}},
+        {"mmap_thp_populate", {BackingOptions::Mapped, BackingOptions::TransparentHugePages, true}},
+        {"mmap_hugetlb", {BackingOptions::Mapped, BackingOptions::ExplicitHugePages}},
+    };
+    
+    for(const Mode& mode : modes) {
+        long before = pageFaults();
+        auto& startup = state.run(std::string("startup/") + mode.name, [&] {
+            Vector v(n, mode.options);
+            for(size_t i = 0; i < n; ++i)
+                v[i] = static_cast<double>(i);
+            bench::doNotOptimize(v[n - 1]);
+        }, n);
+        if(startup.calls)
+            startup.counters["faults"] = double(pageFaults() - before) / startup.calls;
+        
+        if(!state.wants(std::string("random_reads/") + mode.name))
+            continue;
+        Vector v(n, mode.options);
+        for(size_t i = 0; i < n; ++i)
+            v[i] = static_cast<double>(i);
+        state.run(std::string("random_reads/") + mode.name, [&] {
+            bench::doNotOptimize(randomReads(v, reads));
+        }, reads);
+    }
+}
+
+// Opening a dataset of doubles: read-and-copy into a heap Vector versus
+// Vector::mapFile, each followed by a burst of random reads
+BENCH(backing_file) {
+    const size_t n = vectorBytes() / 4 / sizeof(double);
+    constexpr size_t reads = 100'000;
+    if(!state.wants("read_copy") && !state.wants("map"))
+        return;
+    
+    std::string path = std::string(P_tmpdir) + "/dooku_bench_vector.bin";
+    {
+        std::vector<double> block(1 << 20);
+        std::FILE* f = std::fopen(path.c_str(), "wb");
+        if(!f)
+            return;
+        for(size_t done = 0; done < n; done += block.size()) {
+            size_t chunk = std::min(block.size(), n - done);
+            for(size_t i = 0; i < chunk; ++i)
+                block[i] = static_cast<double>(done + i);
+            std::fwrite(block.data(), sizeof(double), chunk, f);
+        }
+        std::fclose(f);
+    }
+    
+    long before = pageFaults();
+    auto& copy = state.run("read_copy", [&] {
+        Vector loaded(n);
+        std::FILE* f = std::fopen(path.c_str(), "rb");
+        bench::doNotOptimize(std::fread(&loaded[0], sizeof(double), n, f));
+        std::fclose(f);
+        bench::doNotOptimize(randomReads(loaded, reads));
+    });
+    if(copy.calls)
+        copy.counters["faults"] = double(pageFaults() - before) / copy.calls;
+    
+    before = pageFaults();
+    auto& mapped = state.run("map", [&] {
+        Vector v = Vector::mapFile(path);
+        bench::doNotOptimize(randomReads(v, reads));
+    });
+    if(mapped.calls)
+        mapped.counters["faults"] = double(pageFaults() - before) / mapped.calls;
+    
+    std::remove(path.c_str());
+}
@@ -0,0 +1,62 @@
+#include "harness.h"
+#include "buffer.h"
+
+#include <vector>
+
+// Pass-through pipeline: produce a packet, split header and payload,
+// forward the payload to a checksum stage
+BENCH(buffer) {
+    constexpr size_t iterations = 10'000;
+    constexpr size_t size = 256;
+    
+    // Owning deep copies at every stage, as the original Buffer did
+    size_t allocations = 0, bytesCopied = 0;
+    auto& copies = state.run("deep_copy", [&] {
+        long long checksum = 0;
+        for(size_t i = 0; i < iterations; ++i) {
+            std::vector<int> packet(size);
+            for(size_t j = 0; j < size; ++j)
+                packet[j] = static_cast<int>(i + j);
+            
+            std::vector<int> header(packet.begin(), packet.begin() + 4);
+            std::vector<int> payload(packet.begin() + 4, packet.end());
+            std::vector<int> forwarded = payload;
+            allocations += 4;
+            bytesCopied += (4 + 2 * (size - 4)) * sizeof(int);
+            
+            checksum += header[0];
+            for(int v : forwarded)
+                checksum += v;
+        }
+        bench::doNotOptimize(checksum);
+    }, iterations);
+    if(copies.calls) {
+        copies.counters["allocations"] = double(allocations) / copies.calls;
+        copies.counters["bytes_copied"] = double(bytesCopied) / copies.calls;
+    }
+    
+    BufferPool pool;
+    auto& pooled = state.run("pooled_slices", [&] {
+        long long checksum = 0;
+        for(size_t i = 0; i < iterations; ++i) {
+            Buffer packet(size, pool);
+            int* out = packet.mutableData();
+            for(size_t j = 0; j < size; ++j)
+                out[j] = static_cast<int>(i + j);
+            
+            Buffer header = packet.slice(0, 4);
+            Buffer payload = packet.slice(4, size - 4);
+            Buffer forwarded = payload;
+            
+            checksum += header[0];
+            for(int v : forwarded)
+                checksum += v;
+        }
+        bench::doNotOptimize(checksum);
+    }, iterations);
+    if(pooled.calls) {
+        auto stats = pool.snapshot();
+        pooled.counters["allocations"] = double(stats.allocations) / pooled.calls;
+        pooled.counters["bytes_copied"] = double(stats.bytesCopied) / pooled.calls;
+    }
+}
@@ -0,0 +1,113 @@
+#include "harness.h"
+#include "compact_value.h"
+
+#include <random>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace {
+
+using Variant = std::variant<int, double, std::string>;
+
+// Heap bytes owned by a std::string beyond the variant itself
+size_t heapBytes(const Variant& v) {
+    if(auto s = std::get_if<std::string>(&v))
+        return s->capacity() > 15 ? s->capacity() + 1 : 0;
+    return 0;
+}
+
+struct Row {
+    int kind;
+    int i;
+    double d;
+    const std::string* s;
+};
+
+}
+
+// 1M mixed values: 40% int, 20% double, 40% strings drawn from a small
+// dictionary of mostly short names
+BENCH(compact_value) {
+    constexpr size_t count = 1'000'000;
+    
+    std::mt19937 rng(42);
+    std::vector<std::string> dictionary;
+    for(int i = 0; i < 2000; ++i) {
+        size_t len = (i % 4 == 0) ? 16 + rng() % 32 : 3 + rng() % 10;
+        std::string s;
+        for(size_t j = 0; j < len; ++j)
+            s += static_cast<char>('a' + rng() % 26);
+        dictionary.push_back(s);
+    }
+    
+    std::vector<Row> rows(count);
+    for(auto& row : rows) {
+        row.kind = rng() % 10;
+        row.i = static_cast<int>(rng());
+        row.d = rng() / 1000.0;
+        row.s = &dictionary[rng() % dictionary.size()];
+    }
+    
+    auto buildVariants = [&] {
+        std::vector<Variant> values;
+        values.reserve(count);
+        for(const auto& row : rows) {
+            if(row.kind < 4) values.emplace_back(row.i);
+            else if(row.kind < 6) values.emplace_back(row.d);
+            else values.emplace_back(*row.s);
+        }
+        return values;
+    };
+    
+    auto buildCompact = [&](StringArena& arena) {
+        std::vector<CompactValue> values;
+        values.reserve(count);
+        for(const auto& row : rows) {
+            if(row.kind < 4) values.emplace_back(row.i);
+            else if(row.kind < 6) values.emplace_back(row.d);
+            else values.emplace_back(*row.s, arena);
+        }
+        return values;
+    };
+    
+    auto variants = buildVariants();
+    StringArena arena;
+    auto compact = buildCompact(arena);
+    
+    size_t variantBytes = variants.capacity() * sizeof(Variant);
+    for(const auto& v : variants)
+        variantBytes += heapBytes(v);
+    size_t compactBytes = compact.capacity() * sizeof(CompactValue) + arena.memoryUsage();
+    
+    // Each Result& is only valid until the next run
+    state.run("build/variant", [&] {
+        bench::doNotOptimize(buildVariants());
+    }, count).counters["bytes"] = double(variantBytes);
+    state.run("build/compact", [&] {
+        StringArena arena;
+        bench::doNotOptimize(buildCompact(arena));
+    }, count).counters["bytes"] = double(compactBytes);
+    
+    state.run("copy/variant", [&] {
+        auto copy = variants;
+        bench::doNotOptimize(copy);
+    }, count);
+    state.run("copy/compact", [&] {
+        auto copy = compact;
+        bench::doNotOptimize(copy);
+    }, count);
+    
+    state.run("compare/variant", [&] {
+        size_t equal = 0;
+        for(size_t i = 1; i < count; ++i)
+            equal += variants[i] == variants[i - 1];
+        bench::doNotOptimize(equal);
+    }, count);
+    state.run("compare/compact", [&] {
+        size_t equal = 0;
+        for(size_t i = 1; i < count; ++i)
+            equal += compact[i] == compact[i - 1];
+        bench::doNotOptimize(equal);
+    }, count);
+}
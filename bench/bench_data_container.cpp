@@ -0,0 +1,150 @@
+#include "harness.h"
+#include "data_container.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+size_t benchThreads() {
+    return std::max(2u, std::thread::hardware_concurrency());
+}
+
+template<typename Policy>
+void runThreading(bench::State& state, const std::string& name) {
+    const size_t threads = benchThreads();
+    constexpr size_t addsPerThread = 250'000;
+    constexpr size_t opsPerThread = 100'000;
+    
+    // Concurrent add throughput, including the merge on sort
+    state.run("add/" + name, [&] {
+        DataContainer<int, AscendingSort, SimplePrint, Policy> adds;
+        std::vector<std::thread> workers;
+        for(size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&adds, t] {
+                for(size_t i = 0; i < addsPerThread; ++i)
+                    adds.add(static_cast<int>(t * addsPerThread + i));
+            });
+        }
+        for(auto& w : workers) w.join();
+        adds.sort();
+        bench::doNotOptimize(adds.size());
+    }, threads * addsPerThread);
+    
+    // Mixed workload: 90% reads, 10% writes
+    state.run("mixed/" + name, [&] {
+        DataContainer<int, AscendingSort, SimplePrint, Policy> mixed;
+        for(int i = 0; i < 1000; ++i)
+            mixed.add(i);
+        std::vector<std::thread> workers;
+        for(size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&mixed, t] {
+                std::mt19937 rng(static_cast<unsigned>(t));
+                long long local = 0;
+                for(size_t i = 0; i < opsPerThread; ++i) {
+                    if(rng() % 10 == 0)
+                        mixed.add(static_cast<int>(i));
+                    else
+                        local += mixed.get(rng() % 1000);
+                }
+                bench::doNotOptimize(local);
+            });
+        }
+        for(auto& w : workers) w.join();
+    }, threads * opsPerThread);
+}
+
+template<typename Policy>
+void runSort(bench::State& state, const std::string& name, const std::vector<int>& input) {
+    // Full sort of a fresh random copy
+    state.run("full/" + name, [&] {
+        DataContainer<int, Policy> container;
+        for(int v : input)
+            container.add(v);
+        container.sort();
+        bench::doNotOptimize(container.get(0));
+    }, input.size());
+    
+    // Append 1% and re-sort; the container keeps growing across repetitions
+    DataContainer<int, Policy> container;
+    for(int v : input)
+        container.add(v);
+    container.sort();
+    std::mt19937 rng(17);
+    const size_t appended = input.size() / 100;
+    state.run("append_resort/" + name, [&] {
+        for(size_t i = 0; i < appended; ++i)
+            container.add(static_cast<int>(rng()));
+        container.sort();
+        bench::doNotOptimize(container.get(0));
+    }, appended);
+}
+
+// Prints into /dev/null by pointing stdout at it for the duration
+template<typename Printer, typename T>
+void runPrint(bench::State& state, const std::string& name, const std::vector<T>& values) {
+    DataContainer<T, AscendingSort, Printer> container;
+    for(const auto& v : values)
+        container.add(v);
+    
+    std::cout.flush();
+    std::fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null = open("/dev/null", O_WRONLY);
+    dup2(null, STDOUT_FILENO);
+    
+    state.run(name, [&] {
+        container.print();
+        std::cout.flush();
+        std::fflush(stdout);
+    }, values.size());
+    
+    dup2(saved, STDOUT_FILENO);
+    close(null);
+    close(saved);
+}
+
+}
+
+BENCH(container_threading) {
+    runThreading<MultiThreaded>(state, "mutex");
+    runThreading<ReaderWriterThreaded>(state, "reader_writer");
+    runThreading<ShardedThreaded<int>>(state, "sharded");
+}
+
+// 4M random ints
+BENCH(container_sorting) {
+    std::vector<int> input(4'000'000);
+    std::mt19937 rng(7);
+    for(auto& v : input)
+        v = static_cast<int>(rng());
+    
+    runSort<AscendingSort>(state, "std_sort", input);
+    runSort<RadixSort<>>(state, "radix", input);
+    runSort<ParallelSort<>>(state, "parallel", input);
+    runSort<IncrementalSort<>>(state, "incremental", input);
+}
+
+// 2M elements
+BENCH(container_printing) {
+    constexpr size_t count = 2'000'000;
+    std::mt19937 rng(3);
+    std::vector<int> ints(count);
+    std::vector<double> doubles(count);
+    for(size_t i = 0; i < count; ++i) {
+        ints[i] = static_cast<int>(rng());
+        doubles[i] = rng() / 1000.0;
+    }
+    
+    runPrint<SimplePrint>(state, "int/simple", ints);
+    runPrint<BatchPrint<>>(state, "int/batch", ints);
+    runPrint<BinaryPrint>(state, "int/binary", ints);
+    runPrint<SimplePrint>(state, "double/simple", doubles);
+    runPrint<BatchPrint<>>(state, "double/batch", doubles);
+    runPrint<BinaryPrint>(state, "double/binary", doubles);
+}
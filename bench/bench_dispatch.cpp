@@ -0,0 +1,172 @@
+#include "harness.h"
+#include "cpu_dispatch.h"
+#include "hashing.h"
+#include "reduce.h"
+#include "stream_manip.h"
+#include "vector_expr.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Every variant of every dispatched kernel on this host: checked against
+// the scalar reference bit for bit, then timed. "active" marks the variant
+// the dispatcher picked (see DOOKU_ISA); "mismatch" must be 0.
+namespace {
+
+template<typename T>
+bool sameBits(const T& a, const T& b) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+template<typename T>
+bool sameBits(const std::vector<T>& a, const std::vector<T>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+// call(fn) runs one variant and returns its result, by value or as a
+// reference to an output buffer
+template<typename Fn, typename Call>
+void runVariants(bench::State& state, const std::string& kernel, const cpu::Kernel<Fn>& variants,
+                 Call&& call, double items) {
+    std::decay_t<decltype(call(variants.scalar))> reference = call(variants.scalar);
+    for(cpu::Isa isa : {cpu::Isa::Scalar, cpu::Isa::AVX2, cpu::Isa::AVX512}) {
+        Fn fn = variants.variant(isa);
+        std::string label = kernel + "/" + cpu::name(isa);
+        if(!fn || !cpu::supported(isa) || !state.wants(label))
+            continue;
+        
+        bool same = sameBits(call(fn), reference);
+        if(!same)
+            std::fprintf(stderr, "dispatch/%s: result differs from scalar\n", label.c_str());
+        auto& result = state.run(label, [&] { bench::doNotOptimize(call(fn)); }, items);
+        result.counters["mismatch"] = same ? 0 : 1;
+        result.counters["active"] = variants.select(cpu::active()) == fn ? 1 : 0;
+    }
+}
+
+// Tokens separated by whitespace runs of 0..maxGap characters, drawn from
+// all six C-locale whitespace characters
+std::string spacedText(std::mt19937& rng, size_t length, unsigned maxGap) {
+    static const char blanks[] = " \t\n\v\f\r";
+    std::string text;
+    while(text.size() < length) {
+        for(unsigned gap = rng() % (maxGap + 1); gap > 0; --gap)
+            text += blanks[rng() % 6];
+        for(unsigned word = 1 + rng() % 8; word > 0; --word)
+            text += static_cast<char>(rng() % 2 ? 'a' + rng() % 26 : 0x80 + rng() % 0x80);
+    }
+    return text;
+}
+
+// Walks text token by token; the sum of token offsets fixes every answer
+size_t tokenOffsets(kernels::FindNonSpace find, const std::string& text) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    size_t offsets = 0;
+    while((p = find(p, end)) != end) {
+        offsets += static_cast<size_t>(p - text.data());
+        while(p != end && !std::isspace(static_cast<unsigned char>(*p)))
+            ++p;
+    }
+    return offsets;
+}
+
+}
+
+BENCH(dispatch) {
+    std::mt19937 rng(11);
+    
+    // jangofett: contiguous sums, in L2 and from memory; odd lengths to
+    // exercise the tails
+    for(size_t count : {32'771, 1'000'003}) {
+        std::string size = count < 100'000 ? "/32k" : "/1m";
+        std::vector<double> doubles(count);
+        std::vector<int> ints(count);
+        for(size_t i = 0; i < count; ++i) {
+            doubles[i] = rng() / 4294967296.0 - 0.25;
+            ints[i] = static_cast<int>(rng());
+        }
+        std::vector<float> floats(doubles.begin(), doubles.end());
+        runVariants(state, "sum_double" + size, kernels::sum_double,
+                    [&](kernels::SumDouble sum) { return sum(doubles.data(), count); }, count);
+        runVariants(state, "sum_float" + size, kernels::sum_float,
+                    [&](kernels::SumFloat sum) { return sum(floats.data(), count); }, count);
+        runVariants(state, "sum_int" + size, kernels::sum_int,
+                    [&](kernels::SumInt sum) { return sum(ints.data(), count); }, count);
+        
+        // Deathstar: v1 + v2 + v3
+        std::vector<double> v2(count), v3(count), out(count);
+        for(size_t i = 0; i < count; ++i) {
+            v2[i] = doubles[count - 1 - i] * 1e8;
+            v3[i] = -doubles[i] / 3;
+        }
+        const double* operands[] = {doubles.data(), v2.data(), v3.data()};
+        runVariants(state, "vector_sum/3" + size, kernels::vector_sum,
+                    [&](kernels::VectorSumN sum) -> const std::vector<double>& {
+                        sum(out.data(), operands, 3, count);
+                        return out;
+                    }, count);
+    }
+    
+    // clonewars: batches of keys. Equal lengths, lengths close enough to
+    // stay vectorized through the masked tail, and ragged ones that go
+    // back to the scalar loop
+    struct KeySet {
+        const char* name;
+        size_t shortest, longest;
+    };
+    for(KeySet set : {KeySet{"len16", 16, 16}, KeySet{"len16-20", 16, 20}, KeySet{"len0-40", 0, 40}}) {
+        std::vector<std::string> strings(100'003);
+        for(auto& s : strings) {
+            s.resize(set.shortest + rng() % (set.longest - set.shortest + 1));
+            for(auto& c : s)
+                c = static_cast<char>(rng());
+        }
+        std::vector<std::string_view> keys(strings.begin(), strings.end());
+        std::vector<uint32_t> hashes(keys.size());
+        runVariants(state, std::string("fnv1a_hash_many/") + set.name, kernels::fnv1a_hash_many,
+                    [&](kernels::HashMany hash) -> const std::vector<uint32_t>& {
+                        hash(keys.data(), keys.size(), hashes.data());
+                        return hashes;
+                    }, keys.size());
+    }
+    
+    // mandalorian: whitespace runs between tokens
+    for(unsigned maxGap : {4u, 64u}) {
+        std::string text = spacedText(rng, 1 << 20, maxGap);
+        runVariants(state, "find_non_space/gap" + std::to_string(maxGap), kernels::find_non_space,
+                    [&](kernels::FindNonSpace find) { return tokenOffsets(find, text); }, text.size());
+    }
+    
+    // The manipulator end to end, with whichever variant is active, against
+    // the peek()/get() loop it replaced
+    std::string text = spacedText(rng, 1 << 18, 16);
+    auto words = [&](auto skip) {
+        std::istringstream in(text);
+        std::string word;
+        size_t n = 0;
+        while(skip(in) >> word)
+            ++n;
+        return n;
+    };
+    state.run("skip_whitespace/peek_get", [&] {
+        bench::doNotOptimize(words([](std::istream& in) -> std::istream& {
+            while(std::isspace(in.peek()))
+                in.get();
+            return in;
+        }));
+    }, text.size());
+    state.run("skip_whitespace/manipulator", [&] {
+        bench::doNotOptimize(words([](std::istream& in) -> std::istream& {
+            return in >> skip_whitespace();
+        }));
+    }, text.size());
+}
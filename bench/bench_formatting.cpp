@@ -0,0 +1,35 @@
+#include "harness.h"
+#include "stream_manip.h"
+
+#include <sstream>
+#include <string>
+
+BENCH(formatting) {
+    constexpr int count = 100'000;
+    
+    state.run("binary", [&] {
+        std::ostringstream out;
+        for(int i = 0; i < count; ++i)
+            out << binary(i) << '\n';
+        bench::doNotOptimize(out.tellp());
+    }, count);
+    
+    state.run("width", [&] {
+        std::ostringstream out;
+        for(int i = 0; i < count; ++i)
+            out << width(10, '*') << i;
+        bench::doNotOptimize(out.tellp());
+    }, count);
+    
+    std::string input;
+    for(int i = 0; i < count; ++i)
+        input += "   \t " + std::to_string(i);
+    state.run("skip_whitespace", [&] {
+        std::istringstream in(input);
+        long long sum = 0;
+        int value;
+        while(in >> skip_whitespace() >> value)
+            sum += value;
+        bench::doNotOptimize(sum);
+    }, count);
+}
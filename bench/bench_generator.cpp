@@ -0,0 +1,32 @@
+#include "harness.h"
+#include "generator.h"
+
+namespace {
+
+Generator<long long> counter(long long limit) {
+    for(long long i = 0; i < limit; ++i)
+        co_yield i;
+}
+
+}
+
+BENCH(generator) {
+    constexpr long long count = 1'000'000;
+    
+    state.run("loop", [&] {
+        long long sum = 0;
+        for(long long i = 0; i < count; ++i) {
+            bench::doNotOptimize(i);
+            sum += i;
+        }
+        bench::doNotOptimize(sum);
+    }, count);
+    
+    state.run("coroutine", [&] {
+        long long sum = 0;
+        auto gen = counter(count);
+        while(gen.next())
+            sum += gen.value();
+        bench::doNotOptimize(sum);
+    }, count);
+}
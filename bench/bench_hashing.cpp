@@ -0,0 +1,35 @@
+#include "harness.h"
+#include "hashing.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+BENCH(hashing) {
+    std::mt19937 rng(11);
+    for(size_t length : {8, 64, 4096}) {
+        std::vector<std::string> keys(std::max<size_t>(1, 256 * 1024 / length));
+        for(auto& k : keys) {
+            k.resize(length);
+            for(auto& c : k)
+                c = static_cast<char>('a' + rng() % 26);
+        }
+        
+        state.run("fnv1a/" + std::to_string(length), [&] {
+            uint32_t combined = 0;
+            for(const auto& k : keys)
+                combined ^= fnv1a_hash(k);
+            bench::doNotOptimize(combined);
+        }, keys.size() * length).counters["bytes"] = keys.size() * length;
+    }
+    
+    std::vector<std::string> padded(10'000, std::string(16, ' ') + "value" + std::string(16, '\t'));
+    state.run("trim", [&] {
+        size_t total = 0;
+        for(const auto& s : padded)
+            total += trim(s).size();
+        bench::doNotOptimize(total);
+    }, padded.size());
+}
@@ -0,0 +1,85 @@
+#include "harness.h"
+#include "memory_pool.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Point {
+    int x, y, z;
+};
+
+}
+
+// 1M points after churn: raw pool pointers in allocation order versus the
+// dense ObjectStore, plus random handle lookups
+BENCH(memory_pool) {
+    constexpr size_t n = 1'000'000;
+    std::mt19937 rng(13);
+    
+    MemoryPool pool(sizeof(Point), n);
+    std::vector<Point*> points;
+    for(size_t i = 0; i < n; ++i)
+        points.push_back(static_cast<Point*>(pool.allocate()));
+    std::shuffle(points.begin(), points.end(), rng);
+    for(size_t i = 0; i < n / 2; ++i)
+        pool.deallocate(points[i]);
+    for(size_t i = 0; i < n / 2; ++i)
+        points[i] = static_cast<Point*>(pool.allocate());
+    std::shuffle(points.begin(), points.end(), rng);
+    for(size_t i = 0; i < n; ++i)
+        *points[i] = Point{int(i), int(i * 2), int(i * 3)};
+    
+    ObjectStore<Point> store(n);
+    std::vector<Handle> handles;
+    for(size_t i = 0; i < n; ++i)
+        handles.push_back(store.create(int(i), int(i * 2), int(i * 3)));
+    std::shuffle(handles.begin(), handles.end(), rng);
+    for(size_t i = 0; i < n / 2; ++i)
+        store.erase(handles[i]);
+    for(size_t i = 0; i < n / 2; ++i)
+        handles[i] = store.create(int(i), int(i * 2), int(i * 3));
+    std::shuffle(handles.begin(), handles.end(), rng);
+    
+    state.run("iterate/raw_pointers", [&] {
+        long long sum = 0;
+        for(Point* p : points) {
+            p->x += p->y;
+            sum += p->x + p->z;
+        }
+        bench::doNotOptimize(sum);
+    }, n);
+    
+    state.run("iterate/object_store", [&] {
+        long long sum = 0;
+        store.for_each([&sum](Point& p) {
+            p.x += p.y;
+            sum += p.x + p.z;
+        });
+        bench::doNotOptimize(sum);
+    }, n);
+    
+    state.run("lookup/object_store", [&] {
+        long long sum = 0;
+        for(Handle h : handles)
+            sum += store.get(h)->y;
+        bench::doNotOptimize(sum);
+    }, n);
+    
+    state.run("allocate_free/pool", [&] {
+        MemoryPool local(sizeof(Point), 4096);
+        void* blocks[4096];
+        for(int r = 0; r < 64; ++r) {
+            for(void*& b : blocks)
+                b = local.allocate();
+            for(void* b : blocks)
+                local.deallocate(b);
+        }
+        bench::doNotOptimize(blocks);
+    }, 64 * 4096);
+    
+    for(Point* p : points)
+        pool.deallocate(p);
+}
@@ -0,0 +1,57 @@
+#include "harness.h"
+#include "pipeline.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#if defined(DOOKU_HAVE_PARALLEL_STL)
+#include <execution>
+#endif
+
+// filter even -> square -> sum over 1e6..1e{BENCH_PIPELINE_MAX_EXP} ints
+// (default 1e7; 9 needs about 12 GB of memory)
+BENCH(pipeline) {
+    const char* env = std::getenv("BENCH_PIPELINE_MAX_EXP");
+    int maxExponent = env ? std::atoi(env) : 7;
+    
+    auto isEven = [](int x) { return x % 2 == 0; };
+    auto square = [](int x) { return x * x; };
+    
+    size_t n = 1'000'000;
+    for(int e = 6; e <= maxExponent; ++e, n *= 10) {
+        std::string size = "1e" + std::to_string(e);
+        std::vector<int> numbers(n);
+        std::mt19937 rng(5);
+        for(auto& x : numbers)
+            x = static_cast<int>(rng() % 1000);
+        
+        // Three sequential passes with back_inserter, as in Count.cpp
+        state.run("sequential/" + size, [&] {
+            std::vector<int> evens;
+            std::copy_if(numbers.begin(), numbers.end(), std::back_inserter(evens), isEven);
+            std::vector<int> squares;
+            std::transform(evens.begin(), evens.end(), std::back_inserter(squares), square);
+            bench::doNotOptimize(std::accumulate(squares.begin(), squares.end(), 0LL));
+        }, n);
+
+#if defined(DOOKU_HAVE_PARALLEL_STL)
+        // Standard parallel algorithms, still three passes
+        state.run("std_par/" + size, [&] {
+            std::vector<int> evens(n);
+            evens.erase(std::copy_if(std::execution::par, numbers.begin(), numbers.end(),
+                                     evens.begin(), isEven), evens.end());
+            std::vector<int> squares(evens.size());
+            std::transform(std::execution::par, evens.begin(), evens.end(), squares.begin(), square);
+            bench::doNotOptimize(std::reduce(std::execution::par, squares.begin(), squares.end(), 0LL));
+        }, n);
+#endif
+        
+        state.run("fused/" + size, [&] {
+            auto result = parallel_pipeline(numbers, isEven, square, 0LL);
+            bench::doNotOptimize(result.total);
+        }, n);
+    }
+}
@@ -0,0 +1,45 @@
+#include "harness.h"
+#include "reduce.h"
+
+#include <deque>
+#include <list>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+template<typename C>
+void runKind(bench::State& state, const std::string& kind, const C& container) {
+    using R = container_sum_type<C>;
+    state.run("accumulate/" + kind, [&] {
+        bench::doNotOptimize(std::accumulate(container.begin(), container.end(), R()));
+    }, std::size(container));
+    state.run("sum_all/" + kind, [&] {
+        bench::doNotOptimize(sum_all(container));
+    }, std::size(container));
+}
+
+}
+
+// Throughput per container kind: std::accumulate versus sum_all
+BENCH(reduce) {
+    constexpr size_t count = 4'000'000;
+    std::mt19937 rng(11);
+    std::vector<int> ints(count);
+    std::vector<double> doubles(count);
+    for(size_t i = 0; i < count; ++i) {
+        ints[i] = static_cast<int>(rng() % 1000);
+        doubles[i] = rng() / 4294967296.0;
+    }
+    std::vector<float> floats(doubles.begin(), doubles.end());
+    std::deque<double> deq(doubles.begin(), doubles.end());
+    std::list<double> list(doubles.begin(), doubles.begin() + count / 4);
+    
+    runKind(state, "vector<int>", ints);
+    runKind(state, "vector<float>", floats);
+    runKind(state, "vector<double>", doubles);
+    runKind(state, "deque<double>", deq);
+    runKind(state, "list<double>", list);
+}
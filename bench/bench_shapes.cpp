@@ -0,0 +1,71 @@
+#include "harness.h"
+#include "shapes.h"
+
+#include <memory>
+#include <random>
+#include <variant>
+#include <vector>
+
+namespace {
+
+// Classic runtime polymorphism, for comparison
+struct VirtualShape {
+    virtual ~VirtualShape() = default;
+    virtual double area() const = 0;
+};
+
+struct VirtualCircle : VirtualShape {
+    double radius;
+    explicit VirtualCircle(double r) : radius(r) {}
+    double area() const override { return 3.14159 * radius * radius; }
+};
+
+struct VirtualRectangle : VirtualShape {
+    double width, height;
+    VirtualRectangle(double w, double h) : width(w), height(h) {}
+    double area() const override { return width * height; }
+};
+
+}
+
+// Total area of 4M mixed circles and rectangles
+BENCH(shapes) {
+    constexpr size_t count = 4'000'000;
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<double> dist(0.5, 10.0);
+    
+    std::vector<std::unique_ptr<VirtualShape>> virtuals;
+    std::vector<std::variant<Circle, Rectangle>> variants;
+    ShapeCollection<Circle, Rectangle> collection;
+    for(size_t i = 0; i < count; ++i) {
+        if(rng() % 2) {
+            double r = dist(rng);
+            virtuals.push_back(std::make_unique<VirtualCircle>(r));
+            variants.emplace_back(Circle(r));
+            collection.add(Circle(r));
+        } else {
+            double w = dist(rng), h = dist(rng);
+            virtuals.push_back(std::make_unique<VirtualRectangle>(w, h));
+            variants.emplace_back(Rectangle(w, h));
+            collection.add(Rectangle(w, h));
+        }
+    }
+    
+    state.run("total_area/virtual", [&] {
+        double area = 0;
+        for(const auto& shape : virtuals)
+            area += shape->area();
+        bench::doNotOptimize(area);
+    }, count);
+    
+    state.run("total_area/variant", [&] {
+        double area = 0;
+        for(auto& shape : variants)
+            area += std::visit([](auto& s) { return s.area(); }, shape);
+        bench::doNotOptimize(area);
+    }, count);
+    
+    state.run("total_area/soa", [&] {
+        bench::doNotOptimize(collection.total_area());
+    }, count);
+}
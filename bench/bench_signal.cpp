@@ -0,0 +1,80 @@
+#include "harness.h"
+#include "signals.h"
+
+#include <string>
+#include <vector>
+
+// Disassemble with
+//     objdump -d -C --no-show-raw-insn bench | awk '/<codegen_/,/^$/'
+// to compare the two emit paths for four identical slots.
+namespace {
+
+struct Accumulate {
+    long long* total;
+    void operator()(int v) const { *total += v; }
+};
+
+}
+
+[[gnu::noinline]] void codegen_dynamic_emit(Signal<int>& signal, int value) {
+    signal.emit(value);
+}
+
+[[gnu::noinline]] void codegen_static_emit(
+    StaticSignal<void(int), Accumulate, Accumulate, Accumulate, Accumulate>& signal, int value) {
+    signal.emit(value);
+}
+
+BENCH(signal) {
+    constexpr int emits = 100'000;
+    
+    for(int slots : {1, 8}) {
+        Signal<int> signal;
+        long long total = 0;
+        std::vector<Signal<int>::ScopedConnection> connections;
+        for(int s = 0; s < slots; ++s)
+            connections.push_back(signal.connect([&total](int v) { total += v; }));
+        
+        state.run("emit/" + std::to_string(slots) + "_slots", [&] {
+            for(int i = 0; i < emits; ++i)
+                signal.emit(i);
+            bench::doNotOptimize(total);
+        }, emits);
+    }
+    
+    // Same four subscribers through the dynamic and the static signal; each
+    // has its own counter so the adds do not form one dependency chain
+    long long totals[4] = {};
+    Signal<int> dynamic;
+    std::vector<Signal<int>::ScopedConnection> connections;
+    for(int s = 0; s < 4; ++s)
+        connections.push_back(dynamic.connect(Accumulate{&totals[s]}));
+    StaticSignal<void(int), Accumulate, Accumulate, Accumulate, Accumulate> fixed(
+        Accumulate{&totals[0]}, Accumulate{&totals[1]}, Accumulate{&totals[2]}, Accumulate{&totals[3]});
+    
+    state.run("emit_4_slots/dynamic", [&] {
+        for(int i = 0; i < emits; ++i)
+            codegen_dynamic_emit(dynamic, i);
+        bench::doNotOptimize(totals);
+    }, emits);
+    
+    state.run("emit_4_slots/static", [&] {
+        for(int i = 0; i < emits; ++i)
+            codegen_static_emit(fixed, i);
+        bench::doNotOptimize(totals);
+    }, emits);
+    
+    // Inlined into the caller's loop, where the static calls can fold
+    state.run("emit_4_slots/static_inlined", [&] {
+        for(int i = 0; i < emits; ++i)
+            fixed.emit(i);
+        bench::doNotOptimize(totals);
+    }, emits);
+    
+    state.run("connect_disconnect", [&] {
+        Signal<int> signal;
+        for(int i = 0; i < 1000; ++i) {
+            auto conn = signal.connect([](int) {});
+        }
+    }, 1000);
+}
@@ -0,0 +1,129 @@
+#include "harness.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    sched_getaffinity(0, sizeof(set), &set);
+    for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        if(CPU_ISSET(cpu, &set))
+            cpus.push_back(cpu);
+#endif
+    return cpus;
+}
+
+unsigned spin(unsigned seed, int rounds) {
+    for(int i = 0; i < rounds; ++i)
+        seed = seed * 1664525u + 1013904223u;
+    return seed;
+}
+
+void busyFor(std::chrono::microseconds gap) {
+    auto until = Clock::now() + gap;
+    while(Clock::now() < until)
+        ;
+}
+
+struct Config {
+    std::string name;
+    ThreadPool::Options options;
+};
+
+std::vector<Config> configs() {
+    size_t threads = std::max(2u, std::thread::hardware_concurrency());
+    
+    ThreadPool::Options park;
+    park.threads = threads;
+    
+    ThreadPool::Options spinning = park;
+    spinning.spinLimit = 4096;
+    
+    ThreadPool::Options pinned = park;
+    pinned.cpus = allowedCpus();
+    
+    ThreadPool::Options spinPinned = spinning;
+    spinPinned.cpus = pinned.cpus;
+    
+    ThreadPool::Options elastic;
+    elastic.threads = 1;
+    elastic.maxThreads = threads * 2;
+    elastic.growAfter = std::chrono::microseconds(200);
+    elastic.retireAfter = std::chrono::milliseconds(20);
+    
+    return {{"park", park}, {"spin", spinning}, {"pinned", pinned},
+            {"spin_pinned", spinPinned}, {"elastic", elastic}};
+}
+
+}
+
+BENCH(thread_pool) {
+    for(const auto& config : configs()) {
+        ThreadPool pool(config.options);
+        
+        // Enqueue-to-start latency of single tasks arriving 20us apart, so
+        // workers go idle between them: spinning ones should still be
+        // polling, parking ones need a futex wake-up
+        constexpr int wakes = 1000;
+        std::vector<double> latencies(wakes);
+        auto& wake = state.run("wake/" + config.name, [&] {
+            for(int i = 0; i < wakes; ++i) {
+                busyFor(std::chrono::microseconds(20));
+                auto queued = Clock::now();
+                auto started = pool.enqueue([] { return Clock::now(); }).get();
+                latencies[i] = std::chrono::duration<double, std::nano>(started - queued).count();
+            }
+        }, wakes);
+        std::sort(latencies.begin(), latencies.end());
+        wake.counters["wake_p50_ns"] = latencies[wakes / 2];
+        wake.counters["wake_p99_ns"] = latencies[wakes * 99 / 100];
+        
+        // Bursts of ~1us tasks
+        constexpr size_t tasks = 20'000;
+        auto& burst = state.run("throughput/" + config.name, [&] {
+            std::vector<std::future<unsigned>> results;
+            results.reserve(tasks);
+            for(size_t i = 0; i < tasks; ++i)
+                results.push_back(pool.enqueue([i] { return spin(static_cast<unsigned>(i), 300); }));
+            unsigned combined = 0;
+            for(auto& r : results)
+                combined ^= r.get();
+            bench::doNotOptimize(combined);
+        }, tasks);
+        burst.counters["workers"] = static_cast<double>(pool.size());
+        
+        if(config.options.maxThreads > config.options.threads) {
+            std::this_thread::sleep_for(config.options.retireAfter * 3);
+            burst.counters["workers_after_idle"] = static_cast<double>(pool.size());
+        }
+    }
+    
+    // Round trip of an empty task through the queue
+    ThreadPool pool(std::max(2u, std::thread::hardware_concurrency()));
+    constexpr size_t tasks = 20'000;
+    state.run("enqueue_wait", [&] {
+        std::vector<std::future<int>> results;
+        results.reserve(tasks);
+        for(size_t i = 0; i < tasks; ++i)
+            results.push_back(pool.enqueue([i] { return static_cast<int>(i); }));
+        long long sum = 0;
+        for(auto& r : results)
+            sum += r.get();
+        bench::doNotOptimize(sum);
+    }, tasks);
+}
@@ -0,0 +1,82 @@
+#include "harness.h"
+#include "memory_pool.h"
+#include "signals.h"
+#include "thread_pool.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Cost of the trace points in ThreadPool, Signal and MemoryPool. Each
+// workload runs with recording off and on; in a build without DOOKU_TRACE
+// both rows measure the compiled-out cost.
+namespace {
+
+// Roughly 1us of work the optimizer cannot drop
+unsigned spin(unsigned seed, int rounds) {
+    for(int i = 0; i < rounds; ++i)
+        seed = seed * 1664525u + 1013904223u;
+    return seed;
+}
+
+template<typename F>
+void runBoth(bench::State& state, const std::string& label, F&& body, double items) {
+    state.run(label + "/off", body, items);
+    if(!state.wants(label + "/on"))
+        return;
+    
+    trace::start();
+    auto& on = state.run(label + "/on", body, items);
+    trace::stop();
+    on.counters["events"] = static_cast<double>(trace::eventCount());
+}
+
+}
+
+BENCH(trace) {
+    // Under --trace the recording is already on and must not be reset
+    if(trace::enabled())
+        return;
+    
+    ThreadPool pool(std::max(2u, std::thread::hardware_concurrency()));
+    constexpr int tasks = 10'000;
+    runBoth(state, "thread_pool/1us_tasks", [&] {
+        std::vector<std::future<unsigned>> results;
+        results.reserve(tasks);
+        for(int i = 0; i < tasks; ++i)
+            results.push_back(pool.enqueue([i] { return spin(i, 300); }));
+        unsigned combined = 0;
+        for(auto& r : results)
+            combined ^= r.get();
+        bench::doNotOptimize(combined);
+    }, tasks);
+    
+    // One scope per emit, however many slots it calls
+    constexpr int emits = 100'000;
+    Signal<int> signal;
+    unsigned total = 0;
+    std::vector<Signal<int>::ScopedConnection> connections;
+    for(int s = 0; s < 4; ++s)
+        connections.push_back(signal.connect([&total](int v) { total = spin(total + v, 30); }));
+    runBoth(state, "signal/emit_4_slots", [&] {
+        for(int i = 0; i < emits; ++i)
+            signal.emit(i);
+        bench::doNotOptimize(total);
+    }, emits);
+    
+    // Worst case: the pool operation itself is a couple of instructions;
+    // only new high-water marks are recorded
+    constexpr size_t blocks = 20'000;
+    MemoryPool memory(sizeof(void*) * 2, blocks);
+    std::vector<void*> held(blocks);
+    runBoth(state, "memory_pool/allocate_free", [&] {
+        for(auto& p : held)
+            p = memory.allocate();
+        for(auto* p : held)
+            memory.deallocate(p);
+        bench::doNotOptimize(held.data());
+    }, blocks * 2);
+}
@@ -0,0 +1,272 @@
+#include "harness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "bench_commit.h"
+#include "trace.h"
+
+namespace bench {
+
+namespace {
+
+struct Entry {
+    const char* name;
+    BenchFn fn;
+};
+
+std::vector<Entry>& registry() {
+    static std::vector<Entry> entries;
+    return entries;
+}
+
+std::string escape(const std::string& s) {
+    std::string out;
+    for(char c : s) {
+        if(c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+std::string formatTime(double ns) {
+    char text[32];
+    if(ns < 1e3)
+        std::snprintf(text, sizeof(text), "%.1f ns", ns);
+    else if(ns < 1e6)
+        std::snprintf(text, sizeof(text), "%.2f us", ns / 1e3);
+    else if(ns < 1e9)
+        std::snprintf(text, sizeof(text), "%.2f ms", ns / 1e6);
+    else
+        std::snprintf(text, sizeof(text), "%.3f s", ns / 1e9);
+    return text;
+}
+
+void printTable(const std::vector<Result>& results) {
+    size_t width = 4;
+    for(const auto& r : results)
+        width = std::max(width, r.name.size());
+    
+    std::printf("%-*s %12s %12s %12s %12s %14s\n", int(width), "name",
+                "min", "p50", "p90", "p99", "items/s");
+    for(const auto& r : results) {
+        std::string rate = "-";
+        if(r.items > 0) {
+            char text[32];
+            std::snprintf(text, sizeof(text), "%.3g", r.items / (r.percentile(50) / 1e9));
+            rate = text;
+        }
+        std::printf("%-*s %12s %12s %12s %12s %14s", int(width), r.name.c_str(),
+                    formatTime(r.percentile(0)).c_str(), formatTime(r.percentile(50)).c_str(),
+                    formatTime(r.percentile(90)).c_str(), formatTime(r.percentile(99)).c_str(),
+                    rate.c_str());
+        for(const auto& [key, value] : r.counters)
+            std::printf("  %s=%g", key.c_str(), value);
+        std::printf("\n");
+    }
+}
+
+void writeJson(const std::vector<Result>& results, const Options& options, const std::string& path) {
+    std::ofstream out(path);
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    
+    out << "{\n  \"context\": {\"commit\": \"" << BENCH_GIT_COMMIT << "\", \"date\": \""
+        << date << "\", \"warmup\": " << options.warmup << ", \"repetitions\": "
+        << options.repetitions << "},\n  \"benchmarks\": [\n";
+    for(size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"name\": \"" << escape(r.name) << "\", \"ns\": {"
+            << "\"min\": " << r.percentile(0) << ", \"p50\": " << r.percentile(50)
+            << ", \"p90\": " << r.percentile(90) << ", \"p99\": " << r.percentile(99)
+            << ", \"max\": " << r.percentile(100) << ", \"mean\": " << r.mean() << "}";
+        if(r.items > 0)
+            out << ", \"items_per_second\": " << r.items / (r.percentile(50) / 1e9);
+        out << ", \"counters\": {";
+        bool first = true;
+        for(const auto& [key, value] : r.counters) {
+            out << (first ? "" : ", ") << "\"" << escape(key) << "\": " << value;
+            first = false;
+        }
+        out << "}}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// Reads name -> p50 from a file written by writeJson
+std::map<std::string, double> readMedians(const std::string& path) {
+    std::ifstream in(path);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string text = buffer.str();
+    
+    std::map<std::string, double> medians;
+    size_t pos = 0;
+    const std::string nameKey = "\"name\": \"";
+    const std::string p50Key = "\"p50\": ";
+    while((pos = text.find(nameKey, pos)) != std::string::npos) {
+        pos += nameKey.size();
+        std::string name;
+        while(pos < text.size() && text[pos] != '"') {
+            if(text[pos] == '\\')
+                ++pos;
+            name += text[pos++];
+        }
+        size_t p50 = text.find(p50Key, pos);
+        if(p50 == std::string::npos)
+            break;
+        medians[name] = std::strtod(text.c_str() + p50 + p50Key.size(), nullptr);
+        pos = p50;
+    }
+    return medians;
+}
+
+int compare(const std::string& basePath, const std::string& newPath, double threshold) {
+    auto base = readMedians(basePath);
+    auto current = readMedians(newPath);
+    int regressions = 0;
+    
+    std::printf("%-48s %12s %12s %9s\n", "name", "base p50", "new p50", "change");
+    for(const auto& [name, value] : current) {
+        auto it = base.find(name);
+        if(it == base.end()) {
+            std::printf("%-48s %12s %12s %9s\n", name.c_str(), "-",
+                        formatTime(value).c_str(), "new");
+            continue;
+        }
+        double change = (value / it->second - 1.0) * 100.0;
+        bool regressed = change > threshold;
+        regressions += regressed;
+        std::printf("%-48s %12s %12s %+8.1f%%%s\n", name.c_str(),
+                    formatTime(it->second).c_str(), formatTime(value).c_str(),
+                    change, regressed ? "  REGRESSION" : "");
+    }
+    
+    // Dropped or renamed benchmarks, and ones a --filter run left out
+    size_t missing = 0;
+    for(const auto& [name, value] : base) {
+        if(current.count(name))
+            continue;
+        std::printf("%-48s %12s %12s %9s\n", name.c_str(), formatTime(value).c_str(), "-", "missing");
+        ++missing;
+    }
+    if(missing)
+        std::fprintf(stderr, "%zu benchmark(s) in %s missing from %s\n", missing,
+                     basePath.c_str(), newPath.c_str());
+    return regressions ? 1 : 0;
+}
+
+void usage() {
+    std::printf("usage: bench [--filter text] [--warmup n] [--reps n] [--json file] [--list]\n"
+                "             [--trace file]\n"
+                "       bench --compare base.json new.json [--threshold percent]\n");
+}
+
+}
+
+double Result::percentile(double p) const {
+    if(samples.empty())
+        return 0;
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    double rank = p / 100.0 * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(std::floor(rank));
+    size_t hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (rank - lo);
+}
+
+double Result::mean() const {
+    if(samples.empty())
+        return 0;
+    double sum = 0;
+    for(double s : samples)
+        sum += s;
+    return sum / samples.size();
+}
+
+Registrar::Registrar(const char* name, BenchFn fn) {
+    registry().push_back(Entry{name, fn});
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    bench::Options options;
+    std::string jsonPath;
+    std::string tracePath;
+    double threshold = 5.0;
+    bool list = false;
+    std::vector<std::string> comparePaths;
+    
+    for(int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if(i + 1 >= argc) {
+                bench::usage();
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        
+        if(arg == "--filter") options.filter = next();
+        else if(arg == "--warmup") options.warmup = std::atoi(next().c_str());
+        else if(arg == "--reps") options.repetitions = std::max(1, std::atoi(next().c_str()));
+        else if(arg == "--json") jsonPath = next();
+        else if(arg == "--trace") tracePath = next();
+        else if(arg == "--threshold") threshold = std::atof(next().c_str());
+        else if(arg == "--list") list = true;
+        else if(arg == "--compare") {
+            comparePaths.push_back(next());
+            comparePaths.push_back(next());
+        } else {
+            bench::usage();
+            return 2;
+        }
+    }
+    
+    if(!comparePaths.empty())
+        return bench::compare(comparePaths[0], comparePaths[1], threshold);
+    
+    auto entries = bench::registry();
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return std::strcmp(a.name, b.name) < 0;
+    });
+    
+    if(list) {
+        for(const auto& e : entries)
+            std::printf("%s\n", e.name);
+        return 0;
+    }
+    
+    if(!tracePath.empty()) {
+        if(!DOOKU_TRACE)
+            std::fprintf(stderr, "--trace: built without DOOKU_TRACE, trace will be empty\n");
+        trace::start();
+    }
+    
+    std::vector<bench::Result> results;
+    for(const auto& e : entries) {
+        bench::State state(e.name, options, results);
+        e.fn(state);
+    }
+    
+    if(!tracePath.empty()) {
+        trace::stop();
+        if(!trace::writeChrome(tracePath.c_str()))
+            std::fprintf(stderr, "--trace: cannot write %s\n", tracePath.c_str());
+        trace::printSummary(std::cout);
+    }
+    
+    bench::printTable(results);
+    if(!jsonPath.empty())
+        bench::writeJson(results, options, jsonPath);
+    return 0;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Minimal microbenchmark harness.
+//
+// A benchmark is a function taking a State. Untimed setup goes in the
+// function body; each state.run(label, body) call becomes one result named
+// "<benchmark>/<label>" whose body is timed once per warmup and measured
+// repetition.
+//
+//     BENCH(reduce) {
+//         std::vector<int> v(1 << 20, 1);
+//         state.run("vector<int>", [&] { bench::doNotOptimize(sum_all(v)); }, v.size());
+//     }
+namespace bench {
+
+struct Result {
+    std::string name;
+    std::vector<double> samples;            // nanoseconds per measured repetition
+    size_t calls = 0;                        // warmup + measured repetitions
+    double items = 0;                        // items processed per repetition
+    std::map<std::string, double> counters;  // free-form extra metrics
+    
+    double percentile(double p) const;
+    double mean() const;
+};
+
+struct Options {
+    int warmup = 2;
+    int repetitions = 10;
+    std::string filter;
+};
+
+class State {
+private:
+    std::string benchmark;
+    const Options& options;
+    std::vector<Result>& results;
+    
+    bool selected(const std::string& name) const {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    }
+
+public:
+    State(std::string benchmark, const Options& options, std::vector<Result>& results)
+        : benchmark(std::move(benchmark)), options(options), results(results) {}
+    
+    // Times body; returns the result so callers can attach counters (the
+    // reference is only valid until the next run).
+    // Filtered-out runs return a detached result and never call body.
+    template<typename F>
+    Result& run(const std::string& label, F&& body, double items = 0) {
+        static Result skipped;
+        std::string name = benchmark + "/" + label;
+        if(!selected(name)) {
+            skipped = Result{};
+            return skipped;
+        }
+        
+        Result result;
+        result.name = name;
+        result.items = items;
+        for(int i = 0; i < options.warmup; ++i)
+            body();
+        for(int i = 0; i < options.repetitions; ++i) {
+            auto t0 = std::chrono::steady_clock::now();
+            body();
+            auto t1 = std::chrono::steady_clock::now();
+            result.samples.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+        }
+        result.calls = static_cast<size_t>(options.warmup + options.repetitions);
+        results.push_back(std::move(result));
+        return results.back();
+    }
+    
+    // Lets benchmarks skip expensive setup for runs the filter excludes
+    bool wants(const std::string& label) const {
+        return selected(benchmark + "/" + label);
+    }
+};
+
+using BenchFn = void (*)(State&);
+
+struct Registrar {
+    Registrar(const char* name, BenchFn fn);
+};
+
+// Keeps a value alive as far as the optimizer is concerned
+template<typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Forces memory to be treated as read and written
+inline void clobberMemory() {
+#if defined(__GNUC__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+}
+
+#define BENCH(name) \
+    static void bench_##name(bench::State& state); \
+    static bench::Registrar registrar_##name(#name, bench_##name); \
+    static void bench_##name(bench::State& state)
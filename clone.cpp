@@ -1,45 +1,6 @@
 #include <iostream>
-#include <coroutine>
-#include <memory>
 #include <string>
-
-template<typename T>
-class Generator {
-public:
-    struct promise_type;
-    using handle_type = std::coroutine_handle<promise_type>;
-    
-    struct promise_type {
-        T current_value;
-        
-        Generator get_return_object() {
-            return Generator(handle_type::from_promise(*this));
-        }
-        
-        std::suspend_always initial_suspend() { return {}; }
-        std::suspend_always final_suspend() noexcept { return {}; }
-        void unhandled_exception() { std::terminate(); }
-        
-        std::suspend_always yield_value(T value) {
-            current_value = value;
-            return {};
-        }
-        
-        void return_void() {}
-    };
-    
-    handle_type coro;
-    
-    Generator(handle_type h) : coro(h) {}
-    ~Generator() { if(coro) coro.destroy(); }
-    
-    bool next() {
-        coro.resume();
-        return !coro.done();
-    }
-    
-    T value() { return coro.promise().current_value; }
-};
+#include "generator.h"
 
 Generator<int> fibonacci() {
     int a = 0, b = 1;
@@ -1,20 +1,6 @@
 #include <iostream>
 #include <string_view>
-
-// Compile-time string hashing (FNV-1a)
-constexpr uint32_t fnv1a_hash(std::string_view str) {
-    uint32_t hash = 2166136261u;
-    for(char c : str) {
-        hash ^= static_cast<uint32_t>(c);
-        hash *= 16777619u;
-    }
-    return hash;
-}
-
-// User-defined literal for compile-time hashing
-constexpr uint32_t operator"" _hash(const char* str, size_t len) {
-    return fnv1a_hash(std::string_view(str, len));
-}
+#include "hashing.h"
 
 // Switch-like construct using hashes
 void handle_command(std::string_view cmd) {
@@ -36,19 +22,6 @@ void handle_command(std::string_view cmd) {
     }
 }
 
-// Compile-time string manipulation
-constexpr std::string_view trim(std::string_view str) {
-    auto start = str.begin();
-    while(start != str.end() && (*start == ' ' || *start == '\t'))
-        ++start;
-    
-    auto end = str.end() - 1;
-    while(end >= start && (*end == ' ' || *end == '\t'))
-        --end;
-    
-    return std::string_view(start, end - start + 1);
-}
-
 int main() {
     // Compile-time hash verification
     constexpr auto hash1 = fnv1a_hash("hello");
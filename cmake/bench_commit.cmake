@@ -0,0 +1,25 @@
+# Writes OUTPUT with the short hash of HEAD in SOURCE_DIR as
+# BENCH_GIT_COMMIT. Run at build time so the hash follows new commits
+# without a reconfigure; the file is only rewritten when the hash changes,
+# so an unchanged commit does not rebuild anything.
+
+set(commit "unknown")
+if(GIT_EXECUTABLE)
+    execute_process(COMMAND ${GIT_EXECUTABLE} rev-parse --short HEAD
+                    WORKING_DIRECTORY ${SOURCE_DIR}
+                    OUTPUT_VARIABLE hash
+                    OUTPUT_STRIP_TRAILING_WHITESPACE
+                    RESULT_VARIABLE result
+                    ERROR_QUIET)
+    if(result EQUAL 0 AND hash)
+        set(commit ${hash})
+    endif()
+endif()
+
+set(content "#pragma once\n\n#define BENCH_GIT_COMMIT \"${commit}\"\n")
+if(EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} previous)
+endif()
+if(NOT previous STREQUAL content)
+    file(WRITE ${OUTPUT} "${content}")
+endif()
@@ -1,7 +1,7 @@
 #include <iostream>
-using namespace std
+using namespace std;
 
 int main(){
   cout<<"Revenge of the sith"<<endl;
+  return 0;
 }
-return 0;
@@ -1,88 +1,6 @@
 #include <iostream>
-#include <vector>
-#include <functional>
-#include <memory>
-#include <algorithm>
-
-template<typename... Args>
-class Signal {
-private:
-    struct Connection {
-        std::function<void(Args...)> slot;
-        int id;
-        bool blocked;
-        
-        Connection(std::function<void(Args...)> s, int i) 
-            : slot(s), id(i), blocked(false) {}
-    };
-    
-    std::vector<std::shared_ptr<Connection>> connections;
-    int next_id = 0;
-    
-public:
-    class ScopedConnection {
-    private:
-        Signal* signal;
-        int id;
-        
-    public:
-        ScopedConnection(Signal* s, int i) : signal(s), id(i) {}
-        
-        ScopedConnection(const ScopedConnection&) = delete;
-        
-        ScopedConnection(ScopedConnection&& other) noexcept 
-            : signal(other.signal), id(other.id) {
-            other.signal = nullptr;
-        }
-        
-        ~ScopedConnection() {
-            if(signal) signal->disconnect(id);
-        }
-        
-        void block() { signal->block(id); }
-        void unblock() { signal->unblock(id); }
-    };
-    
-    ScopedConnection connect(std::function<void(Args...)> slot) {
-        auto conn = std::make_shared<Connection>(slot, next_id);
-        connections.push_back(conn);
-        return ScopedConnection(this, next_id++);
-    }
-    
-    void emit(Args... args) {
-        for(const auto& conn : connections) {
-            if(!conn->blocked) {
-                conn->slot(args...);
-            }
-        }
-    }
-    
-    void disconnect(int id) {
-        connections.erase(
-            std::remove_if(connections.begin(), connections.end(),
-                [id](const auto& conn) { return conn->id == id; }),
-            connections.end()
-        );
-    }
-    
-    void block(int id) {
-        for(auto& conn : connections) {
-            if(conn->id == id) {
-                conn->blocked = true;
-                break;
-            }
-        }
-    }
-    
-    void unblock(int id) {
-        for(auto& conn : connections) {
-            if(conn->id == id) {
-                conn->blocked = false;
-                break;
-            }
-        }
-    }
-};
+#include <string>
+#include "signals.h"
 
 // Example usage
 class Button {
@@ -162,5 +80,15 @@ int main() {
     conn1.unblock();
     button.click();
     
+    // Subscribers fixed at compile time
+    std::cout << "\nStatic signal:\n";
+    auto onStaticClick = makeStaticSignal<int>(
+        [&](int clicks) { logger.logDoubleClick(clicks); },
+        [](int clicks) { std::cout << "Counter: " << clicks << " clicks\n"; }
+    );
+    onStaticClick.emit(3);
+    onStaticClick.block(1);
+    onStaticClick.emit(4);
+    
     return 0;
 }
@@ -1,48 +1,5 @@
 #include <iostream>
-
-template<typename Derived>
-class Shape {
-public:
-    void draw() {
-        static_cast<Derived*>(this)->drawImpl();
-    }
-    
-    double area() {
-        return static_cast<Derived*>(this)->areaImpl();
-    }
-};
-
-class Circle : public Shape<Circle> {
-private:
-    double radius;
-    
-public:
-    Circle(double r) : radius(r) {}
-    
-    void drawImpl() {
-        std::cout << "Drawing a circle with radius " << radius << std::endl;
-    }
-    
-    double areaImpl() {
-        return 3.14159 * radius * radius;
-    }
-};
-
-class Rectangle : public Shape<Rectangle> {
-private:
-    double width, height;
-    
-public:
-    Rectangle(double w, double h) : width(w), height(h) {}
-    
-    void drawImpl() {
-        std::cout << "Drawing a rectangle " << width << "x" << height << std::endl;
-    }
-    
-    double areaImpl() {
-        return width * height;
-    }
-};
+#include "shapes.h"
 
 int main() {
     Circle c(5);
@@ -54,5 +11,16 @@ int main() {
     r.draw();
     std::cout << "Area: " << r.area() << std::endl;
     
+    // Mixed collection stored as per-type columns
+    ShapeCollection<Circle, Rectangle> shapes;
+    shapes.add(Circle(1));
+    shapes.add(Rectangle(2, 3));
+    shapes.add(Circle(2));
+    
+    std::cout << "\nCollection of " << shapes.size() << " shapes:\n";
+    shapes.for_each([](auto shape) { shape.draw(); });
+    std::cout << "Circles: " << shapes.count<Circle>() << ", total area: "
+              << shapes.total_area() << std::endl;
+    
     return 0;
 }
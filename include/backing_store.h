@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+// Where large arrays get their memory from
+struct BackingOptions {
+    enum Kind { Heap, Mapped };
+    enum Pages { SmallPages, TransparentHugePages, ExplicitHugePages };
+    
+    Kind kind = Heap;
+    Pages pages = SmallPages;
+    bool populate = false;   // prefault every page up front (MAP_POPULATE)
+};
+
+// Owning handle to a heap block, an anonymous mapping or a file mapping.
+// Heap blocks are zeroed eagerly like new T[n](); mappings are zero-filled
+// lazily by the kernel on first touch.
+class Backing {
+public:
+    enum Source { None, HeapMemory, AnonymousMapping, FileMapping };
+
+private:
+    void* ptr = nullptr;
+    size_t bytes = 0;
+    size_t mappedBytes = 0;
+    Source source = None;
+    BackingOptions::Pages pages = BackingOptions::SmallPages;
+    
+    Backing(void* p, size_t b, size_t m, Source s, BackingOptions::Pages pg)
+        : ptr(p), bytes(b), mappedBytes(m), source(s), pages(pg) {}
+    
+    void reset();
+
+public:
+    Backing() = default;
+    ~Backing() { reset(); }
+    
+    Backing(const Backing&) = delete;
+    Backing& operator=(const Backing&) = delete;
+    
+    Backing(Backing&& other) noexcept
+        : ptr(std::exchange(other.ptr, nullptr)),
+          bytes(std::exchange(other.bytes, 0)),
+          mappedBytes(std::exchange(other.mappedBytes, 0)),
+          source(std::exchange(other.source, None)),
+          pages(other.pages) {}
+    
+    Backing& operator=(Backing&& other) noexcept {
+        if(this != &other) {
+            reset();
+            ptr = std::exchange(other.ptr, nullptr);
+            bytes = std::exchange(other.bytes, 0);
+            mappedBytes = std::exchange(other.mappedBytes, 0);
+            source = std::exchange(other.source, None);
+            pages = other.pages;
+        }
+        return *this;
+    }
+    
+    static Backing allocate(size_t size, const BackingOptions& options = {});
+    
+    // Maps a file copy-on-write: reads come straight from the page cache
+    // and writes stay private to this process
+    static Backing mapFile(const std::string& path, bool populate = false);
+    
+    void* data() const { return ptr; }
+    size_t size() const { return bytes; }
+    Source kind() const { return source; }
+    BackingOptions::Pages pageMode() const { return pages; }
+};
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include "backing_store.h"
+
+// Size-bucketed recycler for buffer storage. Capacities are rounded up to
+// a power of two and released blocks go back to their bucket's free list,
+// up to retainPerBucket bytes per bucket; past that they are freed at once.
+// Blocks at or above mapThreshold bytes live in their own mapping (huge
+// pages by default); smaller ones share one heap allocation with the header.
+class BufferPool {
+public:
+    struct Block {
+        std::atomic<size_t> refs;
+        size_t capacity;
+        BufferPool* pool;
+        Block* next;
+        int* payload;
+        Backing mapping;
+        
+        int* data() { return payload; }
+    };
+    
+    struct Stats {
+        size_t allocations = 0;   // fresh blocks from the heap
+        size_t reuses = 0;        // blocks served from a free list
+        size_t bytesCopied = 0;   // copy-on-write traffic
+        size_t freed = 0;         // released blocks over the retention cap
+    };
+
+private:
+    static constexpr size_t minShift = 6;   // 64 ints
+    static constexpr size_t buckets = 48;
+    
+    Block* freeLists[buckets] = {};
+    size_t cachedBytes[buckets] = {};
+    std::mutex mutex;
+    Stats stats;
+    size_t mapThreshold;
+    BackingOptions largeBlocks;
+    size_t retainPerBucket;
+    
+    // Throws std::length_error past the largest bucket
+    static size_t bucketFor(size_t size);
+    static size_t bytesOf(const Block* block) { return block->capacity * sizeof(int); }
+    static void destroy(Block* block);
+
+public:
+    // The default cap keeps a couple of the smallest mapped blocks per
+    // bucket and hands anything bigger straight back to the system
+    explicit BufferPool(size_t mapThreshold = 4 * 1024 * 1024,
+                        BackingOptions largeBlocks = {BackingOptions::Mapped,
+                                                      BackingOptions::TransparentHugePages},
+                        size_t retainPerBucket = 8 * 1024 * 1024)
+        : mapThreshold(mapThreshold), largeBlocks(largeBlocks), retainPerBucket(retainPerBucket) {}
+    
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+    
+    ~BufferPool() { trim(); }
+    
+    static BufferPool& instance();
+    
+    // Returns a block holding at least `size` ints with a reference count
+    // of 1. Sizes past the largest bucket (2^53 ints) throw std::length_error.
+    Block* acquire(size_t size);
+    
+    void release(Block* block);
+    void recordCopy(size_t bytes);
+    
+    // Hands every cached block back to the heap
+    void trim();
+    
+    Stats snapshot();
+};
+
+// Reference-counted view (offset + length) into pooled storage.
+// Copies and slices share the block; the first mutation through a shared
+// view copies just that view's range into a fresh block.
+class Buffer {
+private:
+    BufferPool::Block* block;
+    size_t offset;
+    size_t length;
+    
+    void retain() const {
+        if(block)
+            block->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    void drop() {
+        if(block && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            block->pool->release(block);
+        block = nullptr;
+    }
+    
+    Buffer(BufferPool::Block* b, size_t off, size_t len)
+        : block(b), offset(off), length(len) {}
+    
+    void unshare();
+
+public:
+    explicit Buffer(size_t s, BufferPool& pool = BufferPool::instance())
+        : block(pool.acquire(s)), offset(0), length(s) {}
+    
+    ~Buffer() { drop(); }
+    
+    Buffer(const Buffer& other)
+        : block(other.block), offset(other.offset), length(other.length) {
+        retain();
+    }
+    
+    Buffer(Buffer&& other) noexcept
+        : block(other.block), offset(other.offset), length(other.length) {
+        other.block = nullptr;
+        other.offset = 0;
+        other.length = 0;
+    }
+    
+    Buffer& operator=(const Buffer& other) {
+        if(this != &other) {
+            other.retain();
+            drop();
+            block = other.block;
+            offset = other.offset;
+            length = other.length;
+        }
+        return *this;
+    }
+    
+    Buffer& operator=(Buffer&& other) noexcept {
+        if(this != &other) {
+            drop();
+            block = std::exchange(other.block, nullptr);
+            offset = std::exchange(other.offset, 0);
+            length = std::exchange(other.length, 0);
+        }
+        return *this;
+    }
+    
+    Buffer slice(size_t off, size_t len) const;
+    
+    size_t size() const { return length; }
+    bool shared() const { return block && block->refs.load(std::memory_order_acquire) > 1; }
+    
+    const int* data() const { return block ? block->data() + offset : nullptr; }
+    const int* begin() const { return data(); }
+    const int* end() const { return data() + length; }
+    int operator[](size_t i) const { return data()[i]; }
+    
+    // Copy-on-write: unshares before handing out a writable pointer
+    int* mutableData() {
+        if(shared())
+            unshare();
+        return block ? block->data() + offset : nullptr;
+    }
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Alternative using overload pattern
+template<class... Ts> struct overload : Ts... { using Ts::operator()...; };
+template<class... Ts> overload(Ts...) -> overload<Ts...>;
+
+// Interned string storage: each distinct string is stored once and
+// referred to by a 32-bit handle. Views stay valid for the arena's lifetime.
+class StringArena {
+private:
+    static constexpr size_t chunkSize = 64 * 1024;
+    
+    std::vector<std::unique_ptr<char[]>> chunks;
+    size_t chunkUsed = chunkSize;
+    std::vector<std::unique_ptr<char[]>> large;
+    size_t largeBytes = 0;
+    std::vector<std::string_view> strings;
+    std::unordered_map<std::string_view, uint32_t> lookup;
+    
+    const char* store(std::string_view s);
+
+public:
+    // Throws std::length_error once 2^32 distinct strings are interned
+    uint32_t intern(std::string_view s);
+    
+    std::string_view get(uint32_t handle) const { return strings[handle]; }
+    size_t count() const { return strings.size(); }
+    
+    size_t memoryUsage() const;
+};
+
+// 16-byte tagged value: int, double, inline string (up to 15 chars)
+// or a handle into a StringArena. Copies are a plain 16-byte copy.
+class CompactValue {
+public:
+    static constexpr size_t inlineCapacity = 15;
+
+private:
+    enum Tag : uint8_t { IntTag = 0, DoubleTag = 1, HandleTag = 2, InlineTag = 3 };
+    
+    // bytes[0..14] hold the payload; bytes[15] holds the tag.
+    // Inline strings store (InlineTag + length) in the tag byte.
+    alignas(8) char bytes[16] = {};
+    
+    uint8_t tag() const { return static_cast<uint8_t>(bytes[15]); }
+    void setTag(uint8_t t) { bytes[15] = static_cast<char>(t); }
+
+public:
+    CompactValue() { setTag(IntTag); }
+    
+    CompactValue(int i) {
+        std::memcpy(bytes, &i, sizeof(i));
+        setTag(IntTag);
+    }
+    
+    CompactValue(double d) {
+        std::memcpy(bytes, &d, sizeof(d));
+        setTag(DoubleTag);
+    }
+    
+    CompactValue(std::string_view s, StringArena& arena) {
+        if(s.size() <= inlineCapacity) {
+            std::memcpy(bytes, s.data(), s.size());
+            setTag(static_cast<uint8_t>(InlineTag + s.size()));
+        } else {
+            uint32_t handle = arena.intern(s);
+            std::memcpy(bytes, &handle, sizeof(handle));
+            setTag(HandleTag);
+        }
+    }
+    
+    bool isInt() const { return tag() == IntTag; }
+    bool isDouble() const { return tag() == DoubleTag; }
+    bool isString() const { return tag() >= HandleTag; }
+    
+    int asInt() const {
+        int i;
+        std::memcpy(&i, bytes, sizeof(i));
+        return i;
+    }
+    
+    double asDouble() const {
+        double d;
+        std::memcpy(&d, bytes, sizeof(d));
+        return d;
+    }
+    
+    std::string_view asString(const StringArena& arena) const {
+        if(tag() == HandleTag) {
+            uint32_t handle;
+            std::memcpy(&handle, bytes, sizeof(handle));
+            return arena.get(handle);
+        }
+        return std::string_view(bytes, tag() - InlineTag);
+    }
+    
+    // Interned strings are unique per arena, so equal strings have equal
+    // handles and every non-double comparison is a 16-byte compare.
+    friend bool operator==(const CompactValue& a, const CompactValue& b) {
+        if(a.isDouble() && b.isDouble())
+            return a.asDouble() == b.asDouble();
+        return std::memcmp(a.bytes, b.bytes, sizeof(a.bytes)) == 0;
+    }
+    
+    friend bool operator!=(const CompactValue& a, const CompactValue& b) {
+        return !(a == b);
+    }
+};
+
+static_assert(sizeof(CompactValue) == 16, "CompactValue must stay 16 bytes");
+
+// Same shape as std::visit; strings are passed as std::string_view
+template<typename F>
+decltype(auto) visit(F&& f, const CompactValue& v, const StringArena& arena) {
+    if(v.isInt())
+        return std::forward<F>(f)(v.asInt());
+    if(v.isDouble())
+        return std::forward<F>(f)(v.asDouble());
+    return std::forward<F>(f)(v.asString(arena));
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+// Runtime CPU feature dispatch.
+//
+// One binary carries several variants of each SIMD kernel: a portable
+// scalar reference plus AVX2 and AVX-512 versions compiled with per-function
+// target attributes, so the rest of the build stays at the baseline ISA.
+// The CPU is probed once; each kernel is bound to the best variant the
+// first time it is called and goes through a plain function pointer after
+// that.
+//
+// DOOKU_ISA=scalar|avx2|avx512 caps the level, for testing the fallbacks on
+// a machine that has the wider units. Every variant of a kernel must return
+// exactly what the scalar one does; bench dispatch checks that and times
+// each variant side by side.
+//
+// Function pointers rather than GNU ifunc: ifunc resolvers run during
+// relocation, before getenv and the C++ runtime can be trusted, and they
+// only exist on ELF targets.
+namespace cpu {
+
+enum class Isa : int {
+    Scalar,
+    AVX2,
+    AVX512    // F + BW + VL
+};
+
+const char* name(Isa isa);
+
+// What this CPU and OS support
+Isa detected();
+
+// detected() capped by DOOKU_ISA; fixed after the first call
+Isa active();
+
+inline bool supported(Isa isa) {
+    return isa <= detected();
+}
+
+// All variants of one kernel. A null variant was not built for this target
+// and falls back to the next narrower one.
+template<typename Fn>
+struct Kernel {
+    Fn scalar;
+    Fn avx2 = nullptr;
+    Fn avx512 = nullptr;
+    
+    Fn variant(Isa isa) const {
+        switch(isa) {
+        case Isa::AVX512: return avx512;
+        case Isa::AVX2: return avx2;
+        default: return scalar;
+        }
+    }
+    
+    Fn select(Isa isa) const {
+        if(isa >= Isa::AVX512 && avx512)
+            return avx512;
+        if(isa >= Isa::AVX2 && avx2)
+            return avx2;
+        return scalar;
+    }
+};
+
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define DOOKU_X86_KERNELS 1
+#define DOOKU_TARGET_AVX2 __attribute__((target("avx2")))
+#define DOOKU_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vl")))
+#else
+#define DOOKU_X86_KERNELS 0
+#endif
@@ -0,0 +1,453 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+// Sorting policies
+struct AscendingSort {
+    template<typename T>
+    bool operator()(const T& a, const T& b) const {
+        return a < b;
+    }
+};
+
+struct DescendingSort {
+    template<typename T>
+    bool operator()(const T& a, const T& b) const {
+        return a > b;
+    }
+};
+
+// Policies below sort the whole vector themselves through a sort(data)
+// member; plain comparators like the two above go through std::sort.
+
+// Maps an arithmetic key to an unsigned integer with the same ordering.
+// Keys wider than 64 bits (long double) have no such integer.
+template<typename T>
+auto radixKey(T value) {
+    static_assert(std::is_arithmetic_v<T> && sizeof(T) <= 8, "radixKey needs arithmetic keys of at most 64 bits");
+    using U = std::conditional_t<sizeof(T) == 1, uint8_t,
+              std::conditional_t<sizeof(T) == 2, uint16_t,
+              std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+    constexpr U signBit = U(1) << (sizeof(U) * 8 - 1);
+    
+    U bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    if constexpr (std::is_floating_point_v<T>)
+        return (bits & signBit) ? U(~bits) : U(bits | signBit);
+    else if constexpr (std::is_signed_v<T>)
+        return U(bits ^ signBit);
+    else
+        return bits;
+}
+
+// LSD radix sort on 8-bit digits for integral and floating point keys.
+// Passes where every key shares the same digit are skipped.
+template<typename Order = AscendingSort>
+struct RadixSort {
+    static_assert(std::is_same_v<Order, AscendingSort> || std::is_same_v<Order, DescendingSort>,
+                  "RadixSort supports AscendingSort or DescendingSort order");
+    
+    template<typename T>
+    void sort(std::vector<T>& data) const {
+        static_assert(std::is_arithmetic_v<T>, "RadixSort needs integral or floating point keys");
+        static_assert(sizeof(T) <= 8, "RadixSort keys are at most 64 bits; sort long double with std::sort");
+        
+        const size_t n = data.size();
+        if(n < 2)
+            return;
+        
+        std::unique_ptr<T[]> scratch(new T[n]);
+        T* src = data.data();
+        T* dst = scratch.get();
+        
+        for(size_t shift = 0; shift < sizeof(T) * 8; shift += 8) {
+            size_t counts[256] = {};
+            for(size_t i = 0; i < n; ++i)
+                ++counts[(radixKey(src[i]) >> shift) & 0xFF];
+            
+            if(counts[(radixKey(src[0]) >> shift) & 0xFF] == n)
+                continue;
+            
+            size_t offset = 0;
+            for(size_t& c : counts) {
+                size_t count = c;
+                c = offset;
+                offset += count;
+            }
+            for(size_t i = 0; i < n; ++i)
+                dst[counts[(radixKey(src[i]) >> shift) & 0xFF]++] = src[i];
+            std::swap(src, dst);
+        }
+        
+        if(src != data.data())
+            std::copy(src, src + n, data.data());
+        if constexpr (std::is_same_v<Order, DescendingSort>)
+            std::reverse(data.begin(), data.end());
+    }
+};
+
+// Sorts one chunk per hardware thread, then merges chunk pairs in
+// parallel rounds until one run is left
+template<typename Compare = AscendingSort>
+struct ParallelSort {
+    Compare compare;
+    size_t minChunk = 1 << 16;
+    size_t maxChunks = 0;  // 0: one per hardware thread
+    
+    template<typename T>
+    void sort(std::vector<T>& data) const {
+        const size_t n = data.size();
+        size_t limit = maxChunks ? maxChunks : std::max(1u, std::thread::hardware_concurrency());
+        size_t chunks = std::min(limit, n / minChunk);
+        if(chunks < 2) {
+            std::sort(data.begin(), data.end(), compare);
+            return;
+        }
+        
+        std::vector<size_t> bounds;
+        for(size_t c = 0; c <= chunks; ++c)
+            bounds.push_back(n * c / chunks);
+        
+        auto runParallel = [](size_t tasks, auto&& fn) {
+            std::vector<std::thread> workers;
+            for(size_t t = 1; t < tasks; ++t)
+                workers.emplace_back(fn, t);
+            fn(0);
+            for(auto& w : workers) w.join();
+        };
+        
+        runParallel(chunks, [&](size_t c) {
+            std::sort(data.begin() + bounds[c], data.begin() + bounds[c + 1], compare);
+        });
+        
+        std::vector<T> buffer(n);
+        std::vector<T>* src = &data;
+        std::vector<T>* dst = &buffer;
+        for(size_t width = 1; width < chunks; width *= 2) {
+            size_t pairs = (chunks + 2 * width - 1) / (2 * width);
+            runParallel(pairs, [&](size_t p) {
+                size_t lo = bounds[p * 2 * width];
+                size_t mid = bounds[std::min(chunks, p * 2 * width + width)];
+                size_t hi = bounds[std::min(chunks, p * 2 * width + 2 * width)];
+                std::merge(src->begin() + lo, src->begin() + mid,
+                           src->begin() + mid, src->begin() + hi,
+                           dst->begin() + lo, compare);
+            });
+            std::swap(src, dst);
+        }
+        if(src != &data)
+            data.swap(buffer);
+    }
+};
+
+// Remembers how much of the vector is already sorted; a re-sort only
+// sorts the appended tail and merges it into the sorted prefix.
+// Relies on DataContainer only ever appending between sorts.
+template<typename Compare = AscendingSort>
+class IncrementalSort {
+private:
+    Compare compare;
+    size_t sortedCount = 0;
+
+public:
+    template<typename T>
+    void sort(std::vector<T>& data) {
+        if(sortedCount > data.size())
+            sortedCount = 0;
+        
+        auto mid = data.begin() + sortedCount;
+        std::sort(mid, data.end(), compare);
+        if(mid != data.begin() && mid != data.end() && compare(*mid, *(mid - 1)))
+            std::inplace_merge(data.begin(), mid, data.end(), compare);
+        sortedCount = data.size();
+    }
+};
+
+// Printing policies
+struct VerbosePrint {
+    template<typename T>
+    void operator()(const T& value, int index) const {
+        std::cout << "Element[" << index << "] = " << value << "\n";
+    }
+};
+
+struct SimplePrint {
+    template<typename T>
+    void operator()(const T& value, int) const {
+        std::cout << value << " ";
+    }
+};
+
+// Formats the whole container into a per-thread buffer and hands it to
+// stdio in large chunks; fwrite passes chunks bigger than the stdio buffer
+// straight to write(). The buffer is cleared but never shrunk, so repeated
+// prints don't reallocate. Concurrent prints run under the shared lock on
+// different threads, so nothing here is per printer. Text output matches SimplePrint. The
+// binary mode writes the raw element bytes with no header or separators.
+template<bool Binary = false>
+struct BatchPrint {
+    static constexpr size_t chunkSize = 1 << 22;
+    
+    std::FILE* out = stdout;
+    
+    template<typename T>
+    static void appendValue(std::string& buffer, const T& value) {
+        static_assert(!std::is_same_v<T, wchar_t> && !std::is_same_v<T, char8_t> &&
+                      !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>,
+                      "std::cout cannot print wide character types");
+        if constexpr (std::is_same_v<T, bool>) {
+            // As std::cout without boolalpha
+            buffer.push_back(value ? '1' : '0');
+        } else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+                             std::is_same_v<T, unsigned char>) {
+            // The ostream overloads print these as characters, not numbers
+            buffer.push_back(static_cast<char>(value));
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            char digits[64];
+            std::to_chars_result r;
+            if constexpr (std::is_floating_point_v<T>)
+                r = std::to_chars(digits, digits + sizeof(digits), value,
+                                  std::chars_format::general, 6);
+            else
+                r = std::to_chars(digits, digits + sizeof(digits), value);
+            buffer.append(digits, r.ptr);
+        } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            buffer.append(std::string_view(value));
+        } else {
+            std::ostringstream os;
+            os << value;
+            buffer.append(os.str());
+        }
+    }
+    
+    void flush(std::string& buffer) const {
+        std::fwrite(buffer.data(), 1, buffer.size(), out);
+        buffer.clear();
+    }
+    
+    template<typename T>
+    void print(const std::vector<T>& data) const {
+        // Keep ordering with anything already sent through std::cout
+        std::cout.flush();
+        
+        if constexpr (Binary) {
+            static_assert(std::is_trivially_copyable_v<T>, "binary output needs trivially copyable elements");
+            std::fwrite(data.data(), sizeof(T), data.size(), out);
+        } else {
+            // Grown from the data so small containers don't map a full chunk
+            thread_local std::string buffer;
+            buffer.clear();
+            buffer.reserve(std::min(chunkSize + 64, 32 + data.size() * 16));
+            buffer.append("Container contents:\n");
+            for(const auto& value : data) {
+                appendValue(buffer, value);
+                buffer.push_back(' ');
+                if(buffer.size() >= chunkSize)
+                    flush(buffer);
+            }
+            buffer.push_back('\n');
+            flush(buffer);
+        }
+        std::fflush(out);
+    }
+};
+
+using BinaryPrint = BatchPrint<true>;
+
+// Threading policies
+//
+// DataContainer drives a policy through:
+//   lock()/unlock()               exclusive access (sort)
+//   lock_shared()/unlock_shared() read access (print, size, get)
+//   append(data, value)           add one element
+//   pending()/collect(data)       merge elements not yet in data,
+//                                 called with the exclusive lock held
+struct SingleThreaded {
+    void lock() {}
+    void unlock() {}
+    void lock_shared() {}
+    void unlock_shared() {}
+    
+    template<typename T>
+    void append(std::vector<T>& data, const T& value) {
+        data.push_back(value);
+    }
+    
+    bool pending() const { return false; }
+    
+    template<typename T>
+    void collect(std::vector<T>&) {}
+};
+
+// One mutex for everything; readers serialize too
+struct MultiThreaded {
+    std::mutex mutex;
+    
+    void lock() { mutex.lock(); }
+    void unlock() { mutex.unlock(); }
+    void lock_shared() { mutex.lock(); }
+    void unlock_shared() { mutex.unlock(); }
+    
+    template<typename T>
+    void append(std::vector<T>& data, const T& value) {
+        std::lock_guard<std::mutex> guard(mutex);
+        data.push_back(value);
+    }
+    
+    bool pending() const { return false; }
+    
+    template<typename T>
+    void collect(std::vector<T>&) {}
+};
+
+// Readers share the lock, writers take it exclusively
+struct ReaderWriterThreaded {
+    std::shared_mutex mutex;
+    
+    void lock() { mutex.lock(); }
+    void unlock() { mutex.unlock(); }
+    void lock_shared() { mutex.lock_shared(); }
+    void unlock_shared() { mutex.unlock_shared(); }
+    
+    template<typename T>
+    void append(std::vector<T>& data, const T& value) {
+        std::lock_guard<std::shared_mutex> guard(mutex);
+        data.push_back(value);
+    }
+    
+    bool pending() const { return false; }
+    
+    template<typename T>
+    void collect(std::vector<T>&) {}
+};
+
+// Each thread appends to its own shard under an uncontended per-shard
+// mutex. Shards are merged into the main vector on the next sort or read.
+template<typename T>
+class ShardedThreaded {
+private:
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::vector<T> items;
+    };
+    
+    std::shared_mutex mutex;
+    size_t shardCount;
+    std::unique_ptr<Shard[]> shards;
+    std::atomic<size_t> unmerged{0};
+    
+    static size_t threadSlot() {
+        static std::atomic<size_t> nextSlot{0};
+        thread_local size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+public:
+    ShardedThreaded()
+        : shardCount(std::max(1u, std::thread::hardware_concurrency())),
+          shards(new Shard[shardCount]) {}
+    
+    void lock() { mutex.lock(); }
+    void unlock() { mutex.unlock(); }
+    void lock_shared() { mutex.lock_shared(); }
+    void unlock_shared() { mutex.unlock_shared(); }
+    
+    void append(std::vector<T>&, const T& value) {
+        Shard& shard = shards[threadSlot() % shardCount];
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        shard.items.push_back(value);
+        unmerged.fetch_add(1, std::memory_order_release);
+    }
+    
+    bool pending() const {
+        return unmerged.load(std::memory_order_acquire) != 0;
+    }
+    
+    void collect(std::vector<T>& data) {
+        if(!pending())
+            return;
+        for(size_t i = 0; i < shardCount; ++i) {
+            std::lock_guard<std::mutex> guard(shards[i].mutex);
+            auto& items = shards[i].items;
+            data.insert(data.end(), items.begin(), items.end());
+            unmerged.fetch_sub(items.size(), std::memory_order_relaxed);
+            items.clear();
+        }
+    }
+};
+
+// Main container with policies
+template<typename T, 
+         typename SortingPolicy = AscendingSort,
+         typename PrintingPolicy = SimplePrint,
+         typename ThreadingPolicy = SingleThreaded>
+class DataContainer {
+private:
+    // Mutable so const readers can lock and fold in pending shard data
+    mutable std::vector<T> data;
+    SortingPolicy sorter;
+    PrintingPolicy printer;
+    mutable ThreadingPolicy threader;
+    
+    // Locks are held through RAII so a throw (bad_alloc from collect, a
+    // sort's scratch space, the printer) cannot leave the container locked
+    std::shared_lock<ThreadingPolicy> lockRead() const {
+        if(threader.pending()) {
+            std::lock_guard<ThreadingPolicy> exclusive(threader);
+            threader.collect(data);
+        }
+        return std::shared_lock<ThreadingPolicy>(threader);
+    }
+
+public:
+    void add(const T& value) {
+        threader.append(data, value);
+    }
+    
+    void sort() {
+        std::lock_guard<ThreadingPolicy> exclusive(threader);
+        threader.collect(data);
+        if constexpr (requires { sorter.sort(data); })
+            sorter.sort(data);
+        else
+            std::sort(data.begin(), data.end(), sorter);
+    }
+    
+    void print() const {
+        auto shared = lockRead();
+        if constexpr (requires { printer.print(data); }) {
+            printer.print(data);
+        } else {
+            std::cout << "Container contents:\n";
+            for(size_t i = 0; i < data.size(); ++i) {
+                printer(data[i], i);
+            }
+            std::cout << "\n";
+        }
+    }
+    
+    size_t size() const {
+        auto shared = lockRead();
+        return data.size();
+    }
+    
+    T get(size_t i) const {
+        auto shared = lockRead();
+        return data[i];
+    }
+};
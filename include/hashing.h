@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "cpu_dispatch.h"
+
+// Compile-time string hashing (FNV-1a)
+constexpr uint32_t fnv1a_hash(std::string_view str) {
+    uint32_t hash = 2166136261u;
+    for(char c : str) {
+        hash ^= static_cast<uint32_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// User-defined literal for compile-time hashing
+constexpr uint32_t operator"" _hash(const char* str, size_t len) {
+    return fnv1a_hash(std::string_view(str, len));
+}
+
+// Runtime-dispatched batch hashing (src/hashing.cpp): out[i] is
+// fnv1a_hash(keys[i]). A single FNV-1a is one serial multiply chain, so
+// the SIMD variants hash 8 (AVX2) or 16 (AVX-512) keys at once, one per
+// lane.
+namespace kernels {
+
+using HashMany = void (*)(const std::string_view* keys, size_t n, uint32_t* out);
+
+extern const cpu::Kernel<HashMany> fnv1a_hash_many;
+
+}
+
+void fnv1a_hash_many(const std::string_view* keys, size_t n, uint32_t* out);
+
+// Compile-time string manipulation
+constexpr std::string_view trim(std::string_view str) {
+    auto start = str.begin();
+    while(start != str.end() && (*start == ' ' || *start == '\t'))
+        ++start;
+    
+    auto end = str.end() - 1;
+    while(end >= start && (*end == ' ' || *end == '\t'))
+        --end;
+    
+    return std::string_view(start, end - start + 1);
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "trace.h"
+
+class MemoryPool {
+private:
+    struct Block {
+        Block* next;
+    };
+    
+    Block* freeList;
+    char* pool;
+    size_t blockSize;
+    size_t poolSize;
+    size_t inUse = 0;
+    size_t peak = 0;
+    
+    // Only a new high-water mark is recorded: an event per operation costs
+    // many times the operation itself, and once the pool has warmed up
+    // this branch is never taken
+    void notePeak() {
+        if(inUse > peak) {
+            peak = inUse;
+            TRACE_COUNTER("MemoryPool::peak", peak, this);
+        }
+    }
+
+public:
+    MemoryPool(size_t blockSize, size_t numBlocks) 
+        : blockSize(blockSize), poolSize(blockSize * numBlocks) {
+        
+        pool = new char[poolSize];
+        freeList = reinterpret_cast<Block*>(pool);
+        
+        Block* current = freeList;
+        for(size_t i = 0; i < numBlocks - 1; ++i) {
+            Block* next = reinterpret_cast<Block*>(
+                pool + (i + 1) * blockSize
+            );
+            current->next = next;
+            current = next;
+        }
+        current->next = nullptr;
+    }
+    
+    void* allocate() {
+        if(freeList == nullptr) {
+            TRACE_INSTANT("MemoryPool::exhausted", poolSize / blockSize);
+            throw std::bad_alloc();
+        }
+        
+        Block* block = freeList;
+        freeList = freeList->next;
+        ++inUse;
+        notePeak();
+        return block;
+    }
+    
+    void deallocate(void* ptr) {
+        if(ptr == nullptr) return;
+        
+        Block* block = static_cast<Block*>(ptr);
+        block->next = freeList;
+        freeList = block;
+        --inUse;
+    }
+    
+    size_t used() const { return inUse; }
+    size_t peakUsed() const { return peak; }
+    
+    ~MemoryPool() {
+        delete[] pool;
+    }
+};
+
+// 32-bit handle: 20-bit slot index + 12-bit generation. The default
+// handle (all bits set) is never issued: index indexMask is out of range
+// and a slot retires before its generation reaches generationMask.
+struct Handle {
+    static constexpr uint32_t indexBits = 20;
+    static constexpr uint32_t indexMask = (1u << indexBits) - 1;
+    static constexpr uint32_t generationMask = (1u << (32 - indexBits)) - 1;
+    
+    uint32_t bits = ~0u;
+    
+    uint32_t index() const { return bits & indexMask; }
+    uint32_t generation() const { return bits >> indexBits; }
+    
+    static Handle make(uint32_t index, uint32_t generation) {
+        return Handle{(generation & generationMask) << indexBits | index};
+    }
+    
+    friend bool operator==(Handle a, Handle b) { return a.bits == b.bits; }
+};
+
+// Typed object store with generation-checked handles. Live objects stay
+// packed in [0, size) of the store's own storage: create constructs at
+// size(), erase moves the last object into the hole. A slot whose
+// generation would wrap is retired for good rather than reused, so a stale
+// handle can never match again; once every slot index has been used up,
+// create throws std::length_error.
+template<typename T>
+class ObjectStore {
+private:
+    struct Slot {
+        uint32_t dense;
+        uint32_t generation;
+    };
+    
+    T* base;
+    size_t capacity;
+    size_t count = 0;
+    std::vector<Slot> slots;             // handle index -> dense index
+    std::vector<uint32_t> denseToSlot;   // dense index -> handle index
+    std::vector<uint32_t> freeSlots;
+
+public:
+    explicit ObjectStore(size_t capacity)
+        : base(static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t(alignof(T))))),
+          capacity(capacity) {
+        denseToSlot.reserve(capacity);
+    }
+    
+    ObjectStore(const ObjectStore&) = delete;
+    ObjectStore& operator=(const ObjectStore&) = delete;
+    
+    ~ObjectStore() {
+        while(count > 0)
+            base[--count].~T();
+        ::operator delete(base, std::align_val_t(alignof(T)));
+    }
+    
+    template<typename... Args>
+    Handle create(Args&&... args) {
+        if(count == capacity)
+            throw std::bad_alloc();
+        if(freeSlots.empty() && slots.size() == Handle::indexMask)
+            throw std::length_error("ObjectStore: handle slots exhausted");
+        denseToSlot.push_back(0);
+        try {
+            new(base + count) T{std::forward<Args>(args)...};
+        } catch(...) {
+            denseToSlot.pop_back();
+            throw;
+        }
+        
+        uint32_t slot;
+        if(!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(slots.size());
+            slots.push_back(Slot{0, 0});
+        }
+        slots[slot].dense = static_cast<uint32_t>(count);
+        denseToSlot[count] = slot;
+        ++count;
+        return Handle::make(slot, slots[slot].generation);
+    }
+    
+    bool valid(Handle h) const {
+        return h.index() < slots.size()
+            && slots[h.index()].generation == h.generation()
+            && slots[h.index()].dense != ~0u;
+    }
+    
+    // Returns nullptr for stale or erased handles
+    T* get(Handle h) {
+        return valid(h) ? base + slots[h.index()].dense : nullptr;
+    }
+    
+    const T* get(Handle h) const {
+        return valid(h) ? base + slots[h.index()].dense : nullptr;
+    }
+    
+    bool erase(Handle h) {
+        if(!valid(h))
+            return false;
+        
+        uint32_t hole = slots[h.index()].dense;
+        uint32_t last = static_cast<uint32_t>(count - 1);
+        if(hole != last) {
+            base[hole] = std::move(base[last]);
+            denseToSlot[hole] = denseToSlot[last];
+            slots[denseToSlot[hole]].dense = hole;
+        }
+        base[last].~T();
+        denseToSlot.pop_back();
+        --count;
+        
+        Slot& slot = slots[h.index()];
+        slot.dense = ~0u;
+        if(++slot.generation < Handle::generationMask)
+            freeSlots.push_back(h.index());
+        return true;
+    }
+    
+    size_t size() const { return count; }
+    T* begin() { return base; }
+    T* end() { return base + count; }
+    
+    template<typename F>
+    void for_each(F f) {
+        for(size_t i = 0; i < count; ++i)
+            f(base[i]);
+    }
+};
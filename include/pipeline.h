@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <functional>
+#include <type_traits>
+
+// Runs fn(chunk, begin, end) for each of `chunks` equal slices of [0, n),
+// one thread per chunk
+template<typename Fn>
+void parallel_chunks(size_t n, size_t chunks, Fn fn) {
+    std::vector<std::thread> workers;
+    for(size_t c = 1; c < chunks; ++c)
+        workers.emplace_back(fn, c, n * c / chunks, n * (c + 1) / chunks);
+    fn(0, 0, n / chunks);
+    for(auto& w : workers) w.join();
+}
+
+template<typename R, typename Acc>
+struct PipelineResult {
+    std::vector<R> values;
+    Acc total;
+};
+
+// Fused filter -> transform -> reduce.
+// Pass 1 counts matches per chunk; an exclusive prefix sum over the counts
+// gives every chunk its exact output offset. Pass 2 writes the transformed
+// matches straight into the presized output and folds them into a per-chunk
+// partial. Partials start from `identity`, which must be the identity of
+// op (1 for std::multiplies); init is folded in once, with the partials.
+template<typename T, typename Pred, typename Fn, typename Acc, typename Op>
+auto parallel_pipeline(const std::vector<T>& input, Pred pred, Fn fn, Acc init, Op op, Acc identity)
+    -> PipelineResult<std::decay_t<std::invoke_result_t<Fn, const T&>>, Acc> {
+    
+    using R = std::decay_t<std::invoke_result_t<Fn, const T&>>;
+    
+    const size_t n = input.size();
+    const size_t minChunk = 1 << 16;
+    size_t chunks = std::clamp<size_t>(n / minChunk, 1,
+                                       std::max(1u, std::thread::hardware_concurrency()));
+    
+    std::vector<size_t> offsets(chunks + 1, 0);
+    parallel_chunks(n, chunks, [&](size_t c, size_t begin, size_t end) {
+        size_t count = 0;
+        for(size_t i = begin; i < end; ++i)
+            count += pred(input[i]) ? 1 : 0;
+        offsets[c + 1] = count;
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    
+    PipelineResult<R, Acc> result{std::vector<R>(offsets[chunks]), init};
+    std::vector<Acc> partials(chunks, identity);
+    parallel_chunks(n, chunks, [&](size_t c, size_t begin, size_t end) {
+        R* out = result.values.data() + offsets[c];
+        Acc partial = identity;
+        for(size_t i = begin; i < end; ++i) {
+            if(pred(input[i])) {
+                *out = fn(input[i]);
+                partial = op(partial, *out);
+                ++out;
+            }
+        }
+        partials[c] = partial;
+    });
+    
+    for(const auto& partial : partials)
+        result.total = op(result.total, partial);
+    return result;
+}
+
+// Sum: Acc{} is the identity of +
+template<typename T, typename Pred, typename Fn, typename Acc>
+auto parallel_pipeline(const std::vector<T>& input, Pred pred, Fn fn, Acc init) {
+    return parallel_pipeline(input, pred, fn, init, std::plus<>{}, Acc{});
+}
+
+// Accumulator for pipelines with no reduction; folding is a no-op, so
+// values need no arithmetic and nothing can overflow
+struct NoReduce {
+    template<typename V>
+    NoReduce operator()(NoReduce, const V&) const {
+        return {};
+    }
+};
+
+// Filter only: same compaction with the identity transform
+template<typename T, typename Pred>
+std::vector<T> parallel_filter(const std::vector<T>& input, Pred pred) {
+    return parallel_pipeline(input, pred, [](const T& x) { return x; },
+                             NoReduce{}, NoReduce{}, NoReduce{}).values;
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include "cpu_dispatch.h"
+
+// Check if type has begin() and end() methods
+template<typename T>
+class has_iterator {
+private:
+    template<typename U>
+    static auto test(int) -> decltype(
+        std::declval<U>().begin(),
+        std::declval<U>().end(),
+        std::true_type{}
+    );
+    
+    template<typename>
+    static std::false_type test(...);
+
+public:
+    static constexpr bool value = decltype(test<T>(0))::value;
+};
+
+// Contiguous storage: anything exposing data() and size()
+template<typename T>
+class is_contiguous {
+private:
+    template<typename U>
+    static auto test(int) -> decltype(
+        std::data(std::declval<const U&>()),
+        std::size(std::declval<const U&>()),
+        std::true_type{}
+    );
+    
+    template<typename>
+    static std::false_type test(...);
+
+public:
+    static constexpr bool value = decltype(test<T>(0))::value;
+};
+
+// Result of adding two elements, so small integers promote like they
+// would in a hand-written loop
+template<typename T>
+using sum_type = decltype(std::declval<T>() + std::declval<T>());
+
+template<typename C>
+using container_sum_type = sum_type<std::decay_t<decltype(*std::begin(std::declval<const C&>()))>>;
+
+// Integer sums accumulate in the unsigned type of the same width, where
+// overflow wraps instead of being undefined, and convert once at the end.
+// The partial sums may overflow along the way even when the total fits.
+template<typename R>
+using sum_accumulator = typename std::conditional_t<std::is_integral_v<R>, std::make_unsigned<R>,
+                                                    std::type_identity<R>>::type;
+
+// Independent accumulators break the add dependency chain and map onto
+// SIMD lanes: one 64-byte vector's worth, at least eight. The lane count
+// and combine order fix the floating point result, and the SIMD variants
+// in src/reduce.cpp reproduce both exactly.
+template<typename R>
+constexpr size_t sum_lanes = sizeof(R) >= 8 ? 8 : 64 / sizeof(R);
+
+// Adjacent pairs, then pairs of pairs: ((a0 + a1) + (a2 + a3)) + ...
+template<typename R, size_t Lanes>
+R combine_lanes(R (&acc)[Lanes], R tail) {
+    for(size_t width = 1; width < Lanes; width *= 2)
+        for(size_t j = 0; j < Lanes; j += 2 * width)
+            acc[j] += acc[j + width];
+    return acc[0] + tail;
+}
+
+template<typename R, typename T>
+R sum_block(const T* p, size_t n) {
+    using A = sum_accumulator<R>;
+    constexpr size_t lanes = sum_lanes<R>;
+    A acc[lanes] = {};
+    size_t i = 0;
+    for(; i + lanes <= n; i += lanes)
+        for(size_t j = 0; j < lanes; ++j)
+            acc[j] += static_cast<A>(p[i + j]);
+    
+    A tail = A();
+    for(; i < n; ++i)
+        tail += static_cast<A>(p[i]);
+    
+    return static_cast<R>(combine_lanes(acc, tail));
+}
+
+// Pairwise summation: O(log n) rounding error growth for floating point.
+// Leaf sums blocks of up to 256 elements.
+template<typename R, typename T, R (*Leaf)(const T*, size_t) = sum_block<R, T>>
+R sum_pairwise(const T* p, size_t n) {
+    constexpr size_t block = 256;
+    if(n <= block)
+        return Leaf(p, n);
+    size_t half = (n / 2) & ~(sum_lanes<R> - 1);
+    return sum_pairwise<R, T, Leaf>(p, half) + sum_pairwise<R, T, Leaf>(p + half, n - half);
+}
+
+// Runtime-dispatched sums (src/reduce.cpp) for the element types that have
+// SIMD variants; identical results to the templates above
+namespace kernels {
+
+using SumDouble = double (*)(const double*, size_t);
+using SumFloat = float (*)(const float*, size_t);
+using SumInt = int (*)(const int*, size_t);
+
+extern const cpu::Kernel<SumDouble> sum_double;
+extern const cpu::Kernel<SumFloat> sum_float;
+extern const cpu::Kernel<SumInt> sum_int;
+
+}
+
+double sum_dispatched(const double* p, size_t n);
+float sum_dispatched(const float* p, size_t n);
+int sum_dispatched(const int* p, size_t n);
+
+template<typename R, typename T>
+R sum_contiguous(const T* p, size_t n) {
+    if constexpr (std::is_same_v<R, T> && (std::is_same_v<T, double> || std::is_same_v<T, float>
+                                           || std::is_same_v<T, int>))
+        return sum_dispatched(p, n);
+    else if constexpr (std::is_floating_point_v<R>)
+        return sum_pairwise<R>(p, n);
+    else
+        return sum_block<R>(p, n);
+}
+
+// Compensated (Kahan-Babuska) summation when pairwise is not accurate enough
+template<typename It>
+auto kahan_sum(It first, It last) {
+    using R = sum_type<typename std::iterator_traits<It>::value_type>;
+    R sum = R(), compensation = R();
+    for(; first != last; ++first) {
+        R x = *first;
+        R t = sum + x;
+        if(std::abs(sum) >= std::abs(x))
+            compensation += (sum - t) + x;
+        else
+            compensation += (x - t) + sum;
+        sum = t;
+    }
+    return sum + compensation;
+}
+
+// Everything that isn't contiguous. A node's address is only known once
+// the previous node has loaded, so there is nothing to prefetch ahead of
+// the walk; std::deque's blocks are prefetcher friendly already.
+template<typename R, typename It>
+R sum_iterated(It first, It last) {
+    using A = sum_accumulator<R>;
+    A acc = A();
+    for(; first != last; ++first)
+        acc += static_cast<A>(*first);
+    return static_cast<R>(acc);
+}
+
+// Variadic sum: left fold with the usual arithmetic promotions, so
+// sum_all(1, 2.5) is a double. Unary + gives a single argument the same
+// promotion and a value type rather than the declval rvalue reference.
+template<typename... Args>
+typename std::enable_if<(sizeof...(Args) > 0) && (std::is_arithmetic<Args>::value && ...),
+                        decltype((+std::declval<Args>() + ...))>::type
+sum_all(Args... args) {
+    return (... + args);
+}
+
+// Container sum: contiguous ranges take the SIMD kernels, anything else
+// is walked with a plain loop
+template<typename T>
+typename std::enable_if<has_iterator<T>::value, container_sum_type<T>>::type
+sum_all(const T& container) {
+    using R = container_sum_type<T>;
+    if constexpr (is_contiguous<T>::value)
+        return sum_contiguous<R>(std::data(container), std::size(container));
+    else
+        return sum_iterated<R>(container.begin(), container.end());
+}
+
+template<typename T, size_t N>
+typename std::enable_if<std::is_arithmetic<T>::value, sum_type<T>>::type
+sum_all(const T (&array)[N]) {
+    return sum_contiguous<sum_type<T>>(array, N);
+}
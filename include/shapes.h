@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <tuple>
+#include <vector>
+
+template<typename Derived>
+class Shape {
+public:
+    void draw() {
+        static_cast<Derived*>(this)->drawImpl();
+    }
+    
+    double area() {
+        return static_cast<Derived*>(this)->areaImpl();
+    }
+};
+
+// Sums a column-derived value with four accumulators so the loop
+// vectorizes without reassociation flags
+template<typename F>
+double batchSum(size_t n, F value) {
+    double acc[4] = {};
+    size_t i = 0;
+    for(; i + 4 <= n; i += 4)
+        for(size_t j = 0; j < 4; ++j)
+            acc[j] += value(i + j);
+    for(; i < n; ++i)
+        acc[0] += value(i);
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+class Circle : public Shape<Circle> {
+private:
+    double radius;
+
+public:
+    Circle(double r) : radius(r) {}
+    
+    // Structure-of-arrays storage for many circles
+    struct Batch {
+        std::vector<double> radii;
+        
+        void push(const Circle& c) { radii.push_back(c.radius); }
+        size_t size() const { return radii.size(); }
+        
+        double totalArea() const {
+            const double* r = radii.data();
+            return batchSum(radii.size(), [r](size_t i) { return 3.14159 * r[i] * r[i]; });
+        }
+        
+        template<typename F>
+        void forEach(F f) const {
+            for(double r : radii)
+                f(Circle(r));
+        }
+    };
+    
+    void drawImpl() {
+        std::cout << "Drawing a circle with radius " << radius << std::endl;
+    }
+    
+    double areaImpl() {
+        return 3.14159 * radius * radius;
+    }
+};
+
+class Rectangle : public Shape<Rectangle> {
+private:
+    double width, height;
+
+public:
+    Rectangle(double w, double h) : width(w), height(h) {}
+    
+    // Structure-of-arrays storage for many rectangles
+    struct Batch {
+        std::vector<double> widths;
+        std::vector<double> heights;
+        
+        void push(const Rectangle& r) {
+            widths.push_back(r.width);
+            heights.push_back(r.height);
+        }
+        size_t size() const { return widths.size(); }
+        
+        double totalArea() const {
+            const double* w = widths.data();
+            const double* h = heights.data();
+            return batchSum(widths.size(), [w, h](size_t i) { return w[i] * h[i]; });
+        }
+        
+        template<typename F>
+        void forEach(F f) const {
+            for(size_t i = 0; i < widths.size(); ++i)
+                f(Rectangle(widths[i], heights[i]));
+        }
+    };
+    
+    void drawImpl() {
+        std::cout << "Drawing a rectangle " << width << "x" << height << std::endl;
+    }
+    
+    double areaImpl() {
+        return width * height;
+    }
+};
+
+// Mixed shape collection without virtual calls: each concrete type keeps
+// its fields in its own contiguous columns (Derived::Batch), and batch
+// operations run one tight loop per type. Insertion order across types
+// is not preserved.
+template<typename... Shapes>
+class ShapeCollection {
+private:
+    std::tuple<typename Shapes::Batch...> batches;
+
+public:
+    template<typename S>
+    void add(const S& shape) {
+        std::get<typename S::Batch>(batches).push(shape);
+    }
+    
+    size_t size() const {
+        return std::apply([](const auto&... b) { return (b.size() + ... + 0); }, batches);
+    }
+    
+    template<typename S>
+    size_t count() const {
+        return std::get<typename S::Batch>(batches).size();
+    }
+    
+    double total_area() const {
+        return std::apply([](const auto&... b) { return (b.totalArea() + ... + 0.0); }, batches);
+    }
+    
+    // Visits every shape of one type; f receives the shape by value
+    template<typename S, typename F>
+    void for_each(F f) const {
+        std::get<typename S::Batch>(batches).forEach(f);
+    }
+    
+    // Visits every shape, one type after another
+    template<typename F>
+    void for_each(F f) const {
+        std::apply([&f](const auto&... b) { (b.forEach(f), ...); }, batches);
+    }
+};
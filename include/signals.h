@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "trace.h"
+
+template<typename... Args>
+class Signal {
+private:
+    struct Connection {
+        std::function<void(Args...)> slot;
+        int id;
+        bool blocked;
+        
+        Connection(std::function<void(Args...)> s, int i) 
+            : slot(s), id(i), blocked(false) {}
+    };
+    
+    std::vector<std::shared_ptr<Connection>> connections;
+    int next_id = 0;
+
+public:
+    class ScopedConnection {
+    private:
+        Signal* signal;
+        int id;
+    
+    public:
+        ScopedConnection(Signal* s, int i) : signal(s), id(i) {}
+        
+        ScopedConnection(const ScopedConnection&) = delete;
+        
+        ScopedConnection(ScopedConnection&& other) noexcept 
+            : signal(other.signal), id(other.id) {
+            other.signal = nullptr;
+        }
+        
+        ~ScopedConnection() {
+            if(signal) signal->disconnect(id);
+        }
+        
+        void block() { signal->block(id); }
+        void unblock() { signal->unblock(id); }
+    };
+    
+    ScopedConnection connect(std::function<void(Args...)> slot) {
+        auto conn = std::make_shared<Connection>(slot, next_id);
+        connections.push_back(conn);
+        return ScopedConnection(this, next_id++);
+    }
+    
+    void emit(Args... args) {
+        TRACE_SCOPE_ARG("Signal::emit", connections.size());
+        for(const auto& conn : connections) {
+            if(!conn->blocked) {
+                conn->slot(args...);
+            }
+        }
+    }
+    
+    void disconnect(int id) {
+        connections.erase(
+            std::remove_if(connections.begin(), connections.end(),
+                [id](const auto& conn) { return conn->id == id; }),
+            connections.end()
+        );
+    }
+    
+    void block(int id) {
+        for(auto& conn : connections) {
+            if(conn->id == id) {
+                conn->blocked = true;
+                break;
+            }
+        }
+    }
+    
+    void unblock(int id) {
+        for(auto& conn : connections) {
+            if(conn->id == id) {
+                conn->blocked = false;
+                break;
+            }
+        }
+    }
+};
+
+// Signal whose subscribers are fixed at compile time. The slots are stored
+// by value in a tuple (empty lambdas take no space) and emit expands to one
+// direct call per slot, which the compiler can inline; there is no
+// shared_ptr, std::function or vector in between.
+//
+// emit, block and unblock mirror Signal, with a slot's position in the pack
+// as its id, so a member can switch between the two types. Slots cannot be
+// connected or disconnected after construction.
+//
+//     auto onClick = makeStaticSignal<int>(
+//         [&](int clicks) { logger.logDoubleClick(clicks); },
+//         [&](int clicks) { stats.record(clicks); });
+//     onClick.emit(2);
+template<typename Signature, typename... Slots>
+class StaticSignal;
+
+template<typename... Args, typename... Slots>
+class StaticSignal<void(Args...), Slots...> {
+private:
+    static_assert((std::is_invocable_v<Slots&, Args&...> && ...),
+                  "every slot must be callable with the signal's arguments");
+    static_assert(sizeof...(Slots) <= 64, "blocked flags are one 64-bit mask");
+    
+    std::tuple<Slots...> slots;
+    uint64_t blocked = 0;
+    
+    template<size_t... I>
+    void emitEach(std::index_sequence<I...>, Args&... args) {
+        ((blocked & (uint64_t(1) << I) ? void() : void(std::get<I>(slots)(args...))), ...);
+    }
+
+public:
+    static constexpr size_t slotCount = sizeof...(Slots);
+    
+    explicit StaticSignal(Slots... s) : slots(std::move(s)...) {}
+    
+    void emit(Args... args) {
+        emitEach(std::index_sequence_for<Slots...>{}, args...);
+    }
+    
+    // Ids outside [0, slotCount) are a no-op, like an unknown id on Signal
+    void block(int id) {
+        assert(id >= 0 && static_cast<size_t>(id) < slotCount);
+        if(id >= 0 && static_cast<size_t>(id) < slotCount)
+            blocked |= uint64_t(1) << id;
+    }
+    
+    void unblock(int id) {
+        assert(id >= 0 && static_cast<size_t>(id) < slotCount);
+        if(id >= 0 && static_cast<size_t>(id) < slotCount)
+            blocked &= ~(uint64_t(1) << id);
+    }
+    
+    template<size_t I>
+    auto& slot() { return std::get<I>(slots); }
+};
+
+template<typename... Args, typename... Slots>
+StaticSignal<void(Args...), std::decay_t<Slots>...> makeStaticSignal(Slots&&... slots) {
+    return StaticSignal<void(Args...), std::decay_t<Slots>...>(std::forward<Slots>(slots)...);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <iomanip>
+#include <istream>
+#include <ostream>
+#include "cpu_dispatch.h"
+
+// Custom stream manipulator for binary output
+struct binary_manip {
+    int value;
+    binary_manip(int v) : value(v) {}
+};
+
+std::ostream& operator<<(std::ostream& os, const binary_manip& bm);
+
+binary_manip binary(int v);
+
+// Custom stream manipulator with parameters
+class width_wrapper {
+private:
+    int width;
+    char fill;
+
+public:
+    width_wrapper(int w, char f = ' ') : width(w), fill(f) {}
+    
+    friend std::ostream& operator<<(std::ostream& os, const width_wrapper& ww) {
+        os << std::setw(ww.width) << std::setfill(ww.fill);
+        return os;
+    }
+};
+
+width_wrapper width(int w, char fill = ' ');
+
+// First character in [first, last) that is not C-locale whitespace
+// (' ', \t, \n, \v, \f, \r), or last. Runtime-dispatched; the SIMD
+// variants test 32 (AVX2) or 64 (AVX-512) bytes per step.
+namespace kernels {
+
+using FindNonSpace = const char* (*)(const char* first, const char* last);
+
+extern const cpu::Kernel<FindNonSpace> find_non_space;
+
+}
+
+const char* find_non_space(const char* first, const char* last);
+
+// Manipulator that works on input streams. Skips whitespace like a
+// peek()/get() loop would, but past the first couple of characters it
+// copies what the stream buffer already holds into a small window with
+// sgetn, scans that with find_non_space and returns the overshoot with
+// sungetc.
+class skip_whitespace {
+public:
+    skip_whitespace() {}
+    
+    friend std::istream& operator>>(std::istream& is, const skip_whitespace&);
+};
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include "trace.h"
+
+class ThreadPool {
+public:
+    // Defaults reproduce the plain pool: fixed size, workers park at once,
+    // no pinning.
+    struct Options {
+        size_t threads = std::thread::hardware_concurrency();
+        
+        // Spin-then-park: an idle worker polls the queue for up to spinLimit
+        // rounds before sleeping on the condition variable. Each worker
+        // adapts its budget: doubled (up to spinLimit) when spinning found
+        // work, halved (down to spinMin) when it had to park anyway. With
+        // spinning on, spinMin must be in [1, spinLimit].
+        unsigned spinLimit = 0;
+        unsigned spinMin = 16;
+        
+        // Elastic sizing, enabled when maxThreads > threads. A worker is
+        // added once the queue has stayed deeper than backlogPerWorker per
+        // worker for growAfter; a worker idle for retireAfter exits, never
+        // going below threads.
+        size_t maxThreads = 0;
+        size_t backlogPerWorker = 4;
+        std::chrono::microseconds growAfter{1000};
+        std::chrono::milliseconds retireAfter{200};
+        
+        // Linux only: worker i is pinned to cpus[i % cpus.size()] before it
+        // runs anything. Empty leaves placement to the scheduler.
+        std::vector<int> cpus;
+    };
+
+private:
+    struct Task {
+        std::function<void()> run;
+        [[no_unique_address]] trace::Flow queued;    // enqueue -> dequeue, for queue wait
+    };
+    
+    struct Worker {
+        std::thread thread;
+        bool finished = false;    // set under queue_mutex just before exiting
+        bool unpinned = false;    // pinning failed; the worker exits at once
+    };
+    
+    Options options;
+    std::list<Worker> workers;
+    std::queue<Task> tasks;
+    mutable std::mutex queue_mutex;
+    std::condition_variable condition;
+    bool stop;
+    
+    std::atomic<size_t> pending{0};    // tasks.size(), readable without the lock
+    size_t active = 0;                 // workers not finished
+    size_t sleeping = 0;               // workers inside condition.wait
+    size_t spawned = 0;
+    size_t pinFailures = 0;
+    std::chrono::steady_clock::time_point backlogSince{};
+    
+    static void relax() {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#else
+        std::this_thread::yield();
+#endif
+    }
+    
+    static Options sized(size_t threads) {
+        Options options;
+        options.threads = threads;
+        return options;
+    }
+    
+    bool elastic() const { return options.maxThreads > options.threads; }
+    
+    void shutdown() {
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            stop = true;
+        }
+        condition.notify_all();
+        for(Worker& worker : workers)
+            worker.thread.join();
+    }
+    
+    // Caller holds queue_mutex, which the new worker takes before doing
+    // anything, so it only runs once pinned. Returns 0 or the pthread error
+    // from pinning, in which case the worker exits on its own.
+    int spawn() {
+        Worker& worker = workers.emplace_back();
+        size_t index = spawned++;
+        ++active;
+        worker.thread = std::thread([this, &worker] { work(worker); });
+#if defined(__linux__)
+        if(!options.cpus.empty()) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(options.cpus[index % options.cpus.size()], &set);
+            if(int error = pthread_setaffinity_np(worker.thread.native_handle(), sizeof(set), &set)) {
+                worker.unpinned = true;
+                ++pinFailures;
+                return error;
+            }
+        }
+#endif
+        return 0;
+    }
+    
+    // Caller holds queue_mutex. Joins workers that have retired; they are
+    // past their last lock, so the join only waits for the thread to exit.
+    void reap() {
+        for(auto it = workers.begin(); it != workers.end();) {
+            if(it->finished) {
+                it->thread.join();
+                it = workers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    
+    // Caller holds queue_mutex. Runs on enqueue and after every dequeue,
+    // so a backlog queued in one burst still grows the pool once it has
+    // lasted growAfter, with nothing left to enqueue.
+    void growIfBacklogged() {
+        if(active >= options.maxThreads || tasks.size() <= options.backlogPerWorker * active) {
+            backlogSince = {};
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if(backlogSince == std::chrono::steady_clock::time_point{}) {
+            backlogSince = now;
+        } else if(now - backlogSince >= options.growAfter) {
+            reap();
+            // A worker that could not be pinned is not replaced; the pool
+            // stays at its size and affinityFailures() counts it
+            spawn();
+            backlogSince = now;
+        }
+    }
+    
+    void work(Worker& self) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            if(self.unpinned) {
+                --active;
+                self.finished = true;
+                return;
+            }
+        }
+        TRACE_THREAD_NAME("ThreadPool worker");
+        unsigned budget = options.spinLimit;
+        while(true) {
+            if(budget) {
+                unsigned i = 0;
+                while(i < budget && pending.load(std::memory_order_relaxed) == 0) {
+                    relax();
+                    ++i;
+                }
+                budget = i < budget ? std::min(budget * 2, options.spinLimit)
+                                    : std::max(budget / 2, options.spinMin);
+            }
+            
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                if(!stop && tasks.empty()) {
+                    ++sleeping;
+                    if(elastic())
+                        condition.wait_for(lock, options.retireAfter, [this] {
+                            return stop || !tasks.empty();
+                        });
+                    else
+                        condition.wait(lock, [this] {
+                            return stop || !tasks.empty();
+                        });
+                    --sleeping;
+                }
+                
+                if(tasks.empty()) {
+                    if(stop)
+                        return;
+                    if(active > options.threads) {
+                        --active;
+                        self.finished = true;
+                        return;
+                    }
+                    continue;
+                }
+                
+                task = std::move(tasks.front());
+                tasks.pop();
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                if(elastic())
+                    growIfBacklogged();
+            }
+            TRACE_FLOW_END("ThreadPool::dequeue", task.queued);
+            TRACE_SCOPE("ThreadPool::run");
+            task.run();
+        }
+    }
+
+public:
+    ThreadPool(size_t threads) : ThreadPool(sized(threads)) {}
+    
+    explicit ThreadPool(Options opts) : options(std::move(opts)), stop(false) {
+        if(options.threads == 0)
+            options.threads = 1;
+        if(options.spinLimit && (options.spinMin == 0 || options.spinMin > options.spinLimit))
+            throw std::invalid_argument("ThreadPool: spinMin must be between 1 and spinLimit");
+#if defined(__linux__)
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        sched_getaffinity(0, sizeof(allowed), &allowed);
+        for(int cpu : options.cpus) {
+            if(cpu < 0 || cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &allowed))
+                throw std::invalid_argument("ThreadPool: cpu " + std::to_string(cpu) + " is not available");
+        }
+#endif
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        for(size_t i = 0; i < options.threads; ++i) {
+            if(int error = spawn()) {
+                lock.unlock();
+                shutdown();
+                throw std::system_error(error, std::generic_category(),
+                                        "ThreadPool: pinning a worker to cpu " +
+                                        std::to_string(options.cpus[i % options.cpus.size()]));
+            }
+        }
+    }
+    
+    template<class F, class... Args>
+    auto enqueue(F&& f, Args&&... args)
+        -> std::future<typename std::result_of<F(Args...)>::type> {
+        
+        using return_type = typename std::result_of<F(Args...)>::type;
+        
+        auto task = std::make_shared<std::packaged_task<return_type()>>(
+            std::bind(std::forward<F>(f), std::forward<Args>(args)...)
+        );
+        
+        std::future<return_type> result = task->get_future();
+        trace::Flow queued = TRACE_FLOW_BEGIN("ThreadPool::enqueue");
+        bool wake;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            if(stop)
+                throw std::runtime_error("enqueue on stopped ThreadPool");
+            tasks.push(Task{[task](){ (*task)(); }, queued});
+            pending.fetch_add(1, std::memory_order_relaxed);
+            // Spinning and running workers poll the queue themselves; only
+            // parked ones need the futex wake-up
+            wake = sleeping > 0;
+            if(elastic())
+                growIfBacklogged();
+        }
+        if(wake)
+            condition.notify_one();
+        return result;
+    }
+    
+    // Live workers, including ones added by elastic sizing
+    size_t size() const {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        return active;
+    }
+    
+    // Workers added by elastic sizing that could not be pinned and exited
+    size_t affinityFailures() const {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        return pinFailures;
+    }
+    
+    ~ThreadPool() {
+        shutdown();
+    }
+};
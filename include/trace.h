@@ -0,0 +1,204 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifndef DOOKU_TRACE
+#define DOOKU_TRACE 0
+#endif
+
+// Hot-path tracing.
+//
+// Trace points are the TRACE_* macros at the bottom of this file. They
+// compile to nothing unless DOOKU_TRACE is 1 (cmake -DDOOKU_TRACE=ON); when
+// compiled in, a trace point costs one relaxed load until start() is
+// called. While recording, each thread appends to its own chunked buffer,
+// so recording never takes a lock or touches another thread's cache lines.
+//
+//     trace::start();
+//     ... workload ...
+//     trace::stop();
+//     trace::writeChrome("run.json");    // ui.perfetto.dev or chrome://tracing
+//     trace::printSummary(std::cout);     // latency histograms
+//
+// Event names are string literals of the form "Component::event"; the part
+// before "::" becomes the Chrome category.
+namespace trace {
+
+enum class Phase : uint8_t {
+    Complete,    // scope: value = duration
+    Instant,
+    Counter,     // value = counter value, arg = instance (one track per instance)
+    FlowBegin,   // value = flow id, matched with the FlowEnd of the same id
+    FlowEnd
+};
+
+struct Event {
+    uint64_t ts;        // ticks, see now()
+    uint64_t value;
+    uint64_t arg;
+    const char* name;
+    Phase phase;
+};
+
+struct Chunk {
+    static constexpr size_t capacity = 16384;
+    
+    Event events[capacity];
+    std::atomic<size_t> count{0};     // published with release after each event
+    std::atomic<Chunk*> next{nullptr};
+};
+
+// Owned by one thread, then recycled for a later thread once its events
+// have been discarded; read by the exporter
+struct ThreadBuffer {
+    Chunk* head = nullptr;
+    Chunk* tail = nullptr;
+    uint32_t tid = 0;
+    uint64_t flows = 0;    // flow ids are (tid << 40) | ++flows
+    std::atomic<const char*> name{nullptr};
+};
+
+// Links an event on one thread to a later event, usually on another
+// (enqueue -> dequeue). Empty when tracing is compiled out.
+#if DOOKU_TRACE
+struct Flow {
+    uint64_t id = 0;    // 0 = not recorded
+};
+#else
+struct Flow {};
+#endif
+
+namespace detail {
+
+inline std::atomic<bool> active{false};
+inline thread_local ThreadBuffer* current = nullptr;
+
+ThreadBuffer* attach();
+Chunk* grow(ThreadBuffer* buffer);
+
+inline ThreadBuffer* buffer() {
+    return current ? current : attach();
+}
+
+}
+
+// Cheap monotonic timestamp: the TSC on x86, steady_clock nanoseconds
+// elsewhere. Converted to time at export.
+inline uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+inline bool enabled() {
+    return detail::active.load(std::memory_order_relaxed);
+}
+
+inline void record(Phase phase, const char* name, uint64_t ts, uint64_t value, uint64_t arg) {
+    ThreadBuffer* buffer = detail::buffer();
+    Chunk* chunk = buffer->tail;
+    size_t n = chunk ? chunk->count.load(std::memory_order_relaxed) : Chunk::capacity;
+    if(n == Chunk::capacity) {
+        chunk = detail::grow(buffer);
+        n = 0;
+    }
+    chunk->events[n] = Event{ts, value, arg, name, phase};
+    chunk->count.store(n + 1, std::memory_order_release);
+}
+
+inline void instant(const char* name, uint64_t arg = 0) {
+    if(enabled())
+        record(Phase::Instant, name, now(), 0, arg);
+}
+
+inline void counter(const char* name, uint64_t value, const void* instance = nullptr) {
+    if(enabled())
+        record(Phase::Counter, name, now(), value, reinterpret_cast<uintptr_t>(instance));
+}
+
+#if DOOKU_TRACE
+inline Flow flowBegin(const char* name) {
+    if(!enabled())
+        return Flow{};
+    ThreadBuffer* buffer = detail::buffer();
+    Flow flow{uint64_t(buffer->tid) << 40 | ++buffer->flows};
+    record(Phase::FlowBegin, name, now(), flow.id, 0);
+    return flow;
+}
+
+inline void flowEnd(const char* name, Flow flow) {
+    if(flow.id && enabled())
+        record(Phase::FlowEnd, name, now(), flow.id, 0);
+}
+#endif
+
+// Records one Complete event covering its lifetime
+class Scope {
+private:
+    const char* name;
+    uint64_t arg;
+    uint64_t start;
+
+public:
+    explicit Scope(const char* name, uint64_t arg = 0)
+        : name(name), arg(arg), start(enabled() ? now() : 0) {}
+    
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    
+    ~Scope() {
+        if(start)
+            record(Phase::Complete, name, start, now() - start, arg);
+    }
+};
+
+// Names the calling thread in exported traces; name must outlive the trace.
+// Cheap when not recording: the thread gets a buffer on its first event.
+void setThreadName(const char* name);
+
+// Discards previously recorded events and starts recording. Call it while
+// no traced code is running; buffers of live threads are reused, those of
+// exited threads are freed.
+void start();
+void stop();
+
+size_t eventCount();
+
+// Chrome trace event format, readable by Perfetto and chrome://tracing
+bool writeChrome(const char* path);
+
+// Per-name latency histograms for scopes and flows, counts for instants,
+// last/max for counters
+void printSummary(std::ostream& out);
+
+}
+
+#if DOOKU_TRACE
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_SCOPE_ARG(name, arg) trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(name, arg)
+#define TRACE_INSTANT(name, arg) trace::instant(name, arg)
+#define TRACE_COUNTER(name, value, instance) trace::counter(name, value, instance)
+#define TRACE_FLOW_BEGIN(name) trace::flowBegin(name)
+#define TRACE_FLOW_END(name, flow) trace::flowEnd(name, flow)
+#define TRACE_THREAD_NAME(name) trace::setThreadName(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_SCOPE_ARG(name, arg) ((void)0)
+#define TRACE_INSTANT(name, arg) ((void)0)
+#define TRACE_COUNTER(name, value, instance) ((void)0)
+#define TRACE_FLOW_BEGIN(name) trace::Flow{}
+#define TRACE_FLOW_END(name, flow) ((void)(flow))
+#define TRACE_THREAD_NAME(name) ((void)0)
+#endif
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "backing_store.h"
+#include "cpu_dispatch.h"
+
+// out[i] = ((v[0][i] + v[1][i]) + v[2][i]) + ..., adding in the same order
+// as a left-deep chain of VectorSums. Runtime-dispatched
+// (src/vector_expr.cpp); out may alias an operand.
+namespace kernels {
+
+using VectorSumN = void (*)(double* out, const double* const* operands, size_t count, size_t n);
+
+extern const cpu::Kernel<VectorSumN> vector_sum;
+
+}
+
+void vector_sum(double* out, const double* const* operands, size_t count, size_t n);
+
+class Vector;
+
+template<typename E1, typename E2>
+class VectorSum;
+
+// Number of Vectors in a chain ((a + b) + c) + ..., 0 for anything else
+template<typename E>
+constexpr size_t sum_chain_length = 0;
+
+template<>
+constexpr size_t sum_chain_length<Vector> = 1;
+
+template<typename E1>
+constexpr size_t sum_chain_length<VectorSum<E1, Vector>> =
+    sum_chain_length<E1> ? sum_chain_length<E1> + 1 : 0;
+
+template<typename E>
+class VectorExpression {
+public:
+    double operator[](size_t i) const {
+        return static_cast<const E&>(*this)[i];
+    }
+    
+    size_t size() const {
+        return static_cast<const E&>(*this).size();
+    }
+};
+
+class Vector : public VectorExpression<Vector> {
+private:
+    BackingOptions options;
+    Backing storage;
+    double* values;
+    size_t count;
+
+public:
+    Vector(size_t n, const BackingOptions& opts = {})
+        : options(opts),
+          storage(Backing::allocate(n * sizeof(double), opts)),
+          values(static_cast<double*>(storage.data())),
+          count(n) {}
+    
+    template<typename E>
+    Vector(const VectorExpression<E>& expr, const BackingOptions& opts = {})
+        : Vector(expr.size(), opts) {
+        assign(static_cast<const E&>(expr));
+    }
+    
+    Vector(const Vector& other) : Vector(other.count, other.options) {
+        std::copy(other.values, other.values + count, values);
+    }
+    
+    Vector(Vector&& other) noexcept
+        : options(other.options),
+          storage(std::move(other.storage)),
+          values(std::exchange(other.values, nullptr)),
+          count(std::exchange(other.count, 0)) {}
+    
+    Vector& operator=(const Vector& other) {
+        if(this != &other) {
+            if(count != other.count)
+                *this = Vector(other.count, options);
+            std::copy(other.values, other.values + count, values);
+        }
+        return *this;
+    }
+    
+    Vector& operator=(Vector&& other) noexcept {
+        if(this != &other) {
+            options = other.options;
+            storage = std::move(other.storage);
+            values = std::exchange(other.values, nullptr);
+            count = std::exchange(other.count, 0);
+        }
+        return *this;
+    }
+    
+    // Opens a file of raw doubles without reading it; pages are faulted in
+    // from the page cache on first access
+    static Vector mapFile(const std::string& path, bool populate = false) {
+        Vector v(0);
+        v.storage = Backing::mapFile(path, populate);
+        v.values = static_cast<double*>(v.storage.data());
+        v.count = v.storage.size() / sizeof(double);
+        return v;
+    }
+    
+    double operator[](size_t i) const { return values[i]; }
+    double& operator[](size_t i) { return values[i]; }
+    size_t size() const { return count; }
+    const Backing& backing() const { return storage; }
+    
+    // Checked in every build: the SIMD path reads expr.size() elements from
+    // each operand and writes as many here
+    template<typename E>
+    Vector& operator=(const VectorExpression<E>& expr) {
+        if(size() != expr.size())
+            throw std::length_error("Vector: assigning an expression of a different size");
+        assign(static_cast<const E&>(expr));
+        return *this;
+    }
+
+private:
+    // Sums of plain Vectors go to the SIMD kernel; any other expression
+    // is evaluated element by element
+    template<typename E>
+    void assign(const E& expr) {
+        constexpr size_t operands = sum_chain_length<E>;
+        if constexpr (operands >= 2) {
+            const double* columns[operands];
+            chainColumns(expr, columns);
+            vector_sum(values, columns, operands, expr.size());
+        } else {
+            for(size_t i = 0; i < expr.size(); ++i)
+                values[i] = expr[i];
+        }
+    }
+    
+    template<typename E>
+    static void chainColumns(const E& expr, const double** columns) {
+        if constexpr (std::is_same_v<E, Vector>) {
+            columns[0] = expr.values;
+        } else {
+            chainColumns(expr.left(), columns);
+            columns[sum_chain_length<E> - 1] = expr.right().values;
+        }
+    }
+};
+
+template<typename E1, typename E2>
+class VectorSum : public VectorExpression<VectorSum<E1, E2>> {
+private:
+    const E1& u;
+    const E2& v;
+
+public:
+    VectorSum(const E1& u, const E2& v) : u(u), v(v) {
+        if(u.size() != v.size())
+            throw std::length_error("VectorSum: operands differ in size");
+    }
+    
+    double operator[](size_t i) const { return u[i] + v[i]; }
+    size_t size() const { return u.size(); }
+    const E1& left() const { return u; }
+    const E2& right() const { return v; }
+};
+
+template<typename E1, typename E2>
+VectorSum<E1, E2> operator+(const VectorExpression<E1>& u, const VectorExpression<E2>& v) {
+    return VectorSum<E1, E2>(static_cast<const E1&>(u), static_cast<const E2&>(v));
+}
@@ -2,6 +2,10 @@
 #include <type_traits>
 #include <vector>
 #include <list>
+#include <array>
+#include <span>
+#include <numeric>
+#include "reduce.h"
 
 // SFINAE: Enable for integral types only
 template<typename T>
@@ -17,24 +21,6 @@ process(T value) {
     std::cout << "Processing floating point: " << value << "\n";
 }
 
-// Check if type has begin() and end() methods
-template<typename T>
-class has_iterator {
-private:
-    template<typename U>
-    static auto test(int) -> decltype(
-        std::declval<U>().begin(),
-        std::declval<U>().end(),
-        std::true_type{}
-    );
-    
-    template<typename>
-    static std::false_type test(...);
-    
-public:
-    static constexpr bool value = decltype(test<T>(0))::value;
-};
-
 // Overload for containers with iterators
 template<typename T>
 typename std::enable_if<has_iterator<T>::value, void>::type
@@ -53,19 +39,6 @@ print_container(const T&) {
     std::cout << "Not a container\n";
 }
 
-// Variadic templates with SFINAE
-template<typename T>
-typename std::enable_if<std::is_arithmetic<T>::value, T>::type
-sum_all(T t) {
-    return t;
-}
-
-template<typename T, typename... Args>
-typename std::enable_if<std::is_arithmetic<T>::value, T>::type
-sum_all(T t, Args... args) {
-    return t + sum_all(args...);
-}
-
 int main() {
     // Type-based dispatching
     process(42);        // integral
@@ -84,6 +57,22 @@ int main() {
     // Variadic sum
     std::cout << "Sum: " << sum_all(1, 2, 3, 4, 5) << "\n";
     std::cout << "Sum: " << sum_all(1.5, 2.5, 3.5) << "\n";
+    std::cout << "Sum: " << sum_all(1, 2.5) << "\n";
+    
+    // Container reductions
+    int raw[] = {1, 2, 3, 4};
+    std::array<float, 3> arr = {0.5f, 1.5f, 2.5f};
+    std::cout << "Sum: " << sum_all(vec) << " " << sum_all(lst) << " "
+              << sum_all(raw) << " " << sum_all(arr) << " "
+              << sum_all(std::span<const int>(raw, 2)) << "\n";
+    
+    // Accuracy: one million 0.1s
+    std::vector<double> tenths(1'000'000, 0.1);
+    std::cout.precision(17);
+    std::cout << "\nNaive: " << std::accumulate(tenths.begin(), tenths.end(), 0.0)
+              << "\nPairwise: " << sum_all(tenths)
+              << "\nKahan: " << kahan_sum(tenths.begin(), tenths.end()) << "\n";
+    std::cout.precision(6);
     
     return 0;
 }
@@ -1,59 +1,8 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
-
-// Custom stream manipulator for binary output
-struct binary_manip {
-    int value;
-    binary_manip(int v) : value(v) {}
-};
-
-std::ostream& operator<<(std::ostream& os, const binary_manip& bm) {
-    std::string result;
-    int val = bm.value;
-    
-    if(val == 0) result = "0";
-    else {
-        while(val > 0) {
-            result = (val % 2 ? "1" : "0") + result;
-            val /= 2;
-        }
-    }
-    
-    os << "0b" << result;
-    return os;
-}
-
-binary_manip binary(int v) { return binary_manip(v); }
-
-// Custom stream manipulator with parameters
-class width_wrapper {
-private:
-    int width;
-    char fill;
-    
-public:
-    width_wrapper(int w, char f = ' ') : width(w), fill(f) {}
-    
-    friend std::ostream& operator<<(std::ostream& os, const width_wrapper& ww) {
-        os << std::setw(ww.width) << std::setfill(ww.fill);
-        return os;
-    }
-};
-
-width_wrapper width(int w, char fill = ' ') { return width_wrapper(w, fill); }
-
-// Manipulator that works on input streams
-class skip_whitespace {
-public:
-    skip_whitespace() {}
-    
-    friend std::istream& operator>>(std::istream& is, const skip_whitespace&) {
-        while(std::isspace(is.peek()))
-            is.get();
-        return is;
-    }
-};
+#include <string>
+#include "stream_manip.h"
 
 int main() {
     // Binary output
@@ -1,87 +1,8 @@
 #include <iostream>
-#include <vector>
 #include <algorithm>
-
-// Sorting policies
-struct AscendingSort {
-    template<typename T>
-    bool operator()(const T& a, const T& b) const {
-        return a < b;
-    }
-};
-
-struct DescendingSort {
-    template<typename T>
-    bool operator()(const T& a, const T& b) const {
-        return a > b;
-    }
-};
-
-// Printing policies
-struct VerbosePrint {
-    template<typename T>
-    void operator()(const T& value, int index) const {
-        std::cout << "Element[" << index << "] = " << value << "\n";
-    }
-};
-
-struct SimplePrint {
-    template<typename T>
-    void operator()(const T& value, int) const {
-        std::cout << value << " ";
-    }
-};
-
-// Threading policies
-struct SingleThreaded {
-    void lock() const {}
-    void unlock() const {}
-};
-
-struct MultiThreaded {
-    void lock() const {
-        std::cout << "Locking mutex\n";
-    }
-    void unlock() const {
-        std::cout << "Unlocking mutex\n";
-    }
-};
-
-// Main container with policies
-template<typename T, 
-         typename SortingPolicy = AscendingSort,
-         typename PrintingPolicy = SimplePrint,
-         typename ThreadingPolicy = SingleThreaded>
-class DataContainer {
-private:
-    std::vector<T> data;
-    SortingPolicy sorter;
-    PrintingPolicy printer;
-    ThreadingPolicy threader;
-    
-public:
-    void add(const T& value) {
-        threader.lock();
-        data.push_back(value);
-        threader.unlock();
-    }
-    
-    void sort() {
-        threader.lock();
-        std::sort(data.begin(), data.end(), sorter);
-        threader.unlock();
-    }
-    
-    void print() const {
-        threader.lock();
-        std::cout << "Container contents:\n";
-        for(size_t i = 0; i < data.size(); ++i) {
-            printer(data[i], i);
-        }
-        std::cout << "\n";
-        threader.unlock();
-    }
-};
+#include <thread>
+#include <vector>
+#include "data_container.h"
 
 int main() {
     // Different policy combinations
@@ -101,5 +22,30 @@ int main() {
     container2.sort();
     container2.print();
     
+    // Thread-safe variants of the same container
+    DataContainer<int, AscendingSort, SimplePrint, ShardedThreaded<int>> container3;
+    {
+        std::vector<std::thread> workers;
+        for(int t = 0; t < 4; ++t) {
+            workers.emplace_back([&container3, t] {
+                for(int i = 0; i < 5; ++i)
+                    container3.add(t * 5 + i);
+            });
+        }
+        for(auto& w : workers) w.join();
+    }
+    
+    std::cout << "\nContainer 3 (Ascending + Simple + Sharded, 4 writers):\n";
+    container3.sort();
+    container3.print();
+    
+    DataContainer<double, DescendingSort, BatchPrint<>> container4;
+    for(int i = 0; i < 5; ++i)
+        container4.add(i * 1.5);
+    
+    std::cout << "\nContainer 4 (Descending + Batch):\n";
+    container4.sort();
+    container4.print();
+    
     return 0;
 }
@@ -0,0 +1,123 @@
+#include "backing_store.h"
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t hugePageSize = 2 * 1024 * 1024;
+
+size_t roundUp(size_t n, size_t to) { return (n + to - 1) / to * to; }
+
+}
+
+void Backing::reset() {
+    if(source == HeapMemory)
+        ::operator delete(ptr);
+    else if(source == AnonymousMapping || source == FileMapping)
+        munmap(ptr, mappedBytes);
+    ptr = nullptr;
+    bytes = mappedBytes = 0;
+    source = None;
+}
+
+Backing Backing::allocate(size_t size, const BackingOptions& options) {
+    if(size == 0)
+        return Backing();
+    if(options.kind == BackingOptions::Heap) {
+        void* p = ::operator new(size);
+        std::memset(p, 0, size);
+        return Backing(p, size, 0, HeapMemory, BackingOptions::SmallPages);
+    }
+    
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_POPULATE
+    if(options.populate)
+        flags |= MAP_POPULATE;
+#endif
+
+#ifdef MAP_HUGETLB
+    // Explicit huge pages need a reserved pool; fall back to THP without one
+    if(options.pages == BackingOptions::ExplicitHugePages) {
+        size_t length = roundUp(size, hugePageSize);
+        void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+        if(p != MAP_FAILED)
+            return Backing(p, size, length, AnonymousMapping, BackingOptions::ExplicitHugePages);
+    }
+#endif
+    
+    bool huge = options.pages != BackingOptions::SmallPages;
+    size_t length = huge ? roundUp(size, hugePageSize) : size;
+    if(!huge) {
+        void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if(p == MAP_FAILED)
+            throw std::bad_alloc();
+        return Backing(p, size, length, AnonymousMapping, BackingOptions::SmallPages);
+    }
+    
+    // Over-map so the region can start on a huge page boundary, then
+    // trim both ends. The madvise has to come before the first touch,
+    // so huge-page requests do not pass MAP_POPULATE to mmap.
+    size_t span = length + hugePageSize;
+    char* raw = static_cast<char*>(
+        mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if(raw == MAP_FAILED)
+        throw std::bad_alloc();
+    char* aligned = reinterpret_cast<char*>(
+        roundUp(reinterpret_cast<uintptr_t>(raw), hugePageSize));
+    if(aligned > raw)
+        munmap(raw, aligned - raw);
+    size_t tail = (raw + span) - (aligned + length);
+    if(tail)
+        munmap(aligned + length, tail);
+
+#ifdef MADV_HUGEPAGE
+    madvise(aligned, length, MADV_HUGEPAGE);
+#endif
+    if(options.populate) {
+        // MADV_POPULATE_WRITE is Linux 5.14+; older kernels reject it
+        // with EINVAL, so fault the pages in by touching them instead
+        bool populated = false;
+#ifdef MADV_POPULATE_WRITE
+        populated = madvise(aligned, length, MADV_POPULATE_WRITE) == 0;
+#endif
+        if(!populated)
+            for(size_t off = 0; off < length; off += 4096)
+                aligned[off] = 0;
+    }
+    return Backing(aligned, size, length, AnonymousMapping, BackingOptions::TransparentHugePages);
+}
+
+Backing Backing::mapFile(const std::string& path, bool populate) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        throw std::runtime_error("cannot open " + path);
+    
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        close(fd);
+        throw std::runtime_error("cannot stat " + path);
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    if(size == 0) {
+        close(fd);
+        return Backing();
+    }
+    
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if(populate)
+        flags |= MAP_POPULATE;
+#endif
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+    close(fd);
+    if(p == MAP_FAILED)
+        throw std::runtime_error("cannot map " + path);
+    return Backing(p, size, size, FileMapping, BackingOptions::SmallPages);
+}
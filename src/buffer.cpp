@@ -0,0 +1,110 @@
+#include "buffer.h"
+
+#include <bit>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+size_t BufferPool::bucketFor(size_t size) {
+    size_t shift = size > 1 ? std::bit_width(size - 1) : 0;
+    if(shift >= minShift + buckets)
+        throw std::length_error("BufferPool: size exceeds the largest bucket");
+    return shift < minShift ? 0 : shift - minShift;
+}
+
+void BufferPool::destroy(Block* block) {
+    if(block->mapping.data()) {
+        delete block;
+    } else {
+        block->~Block();
+        ::operator delete(block);
+    }
+}
+
+BufferPool& BufferPool::instance() {
+    static BufferPool pool;
+    return pool;
+}
+
+BufferPool::Block* BufferPool::acquire(size_t size) {
+    size_t bucket = bucketFor(size);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(Block* block = freeLists[bucket]) {
+            freeLists[bucket] = block->next;
+            cachedBytes[bucket] -= bytesOf(block);
+            block->refs.store(1, std::memory_order_relaxed);
+            ++stats.reuses;
+            return block;
+        }
+        ++stats.allocations;
+    }
+    
+    size_t capacity = size_t(1) << (bucket + minShift);
+    if(capacity * sizeof(int) >= mapThreshold) {
+        Backing mapping = Backing::allocate(capacity * sizeof(int), largeBlocks);
+        int* payload = static_cast<int*>(mapping.data());
+        return new Block{{1}, capacity, this, nullptr, payload, std::move(mapping)};
+    }
+    void* raw = ::operator new(sizeof(Block) + capacity * sizeof(int));
+    Block* block = new(raw) Block{{1}, capacity, this, nullptr, nullptr, Backing()};
+    block->payload = reinterpret_cast<int*>(block + 1);
+    return block;
+}
+
+void BufferPool::release(Block* block) {
+    size_t bucket = bucketFor(block->capacity);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(cachedBytes[bucket] + bytesOf(block) <= retainPerBucket) {
+            cachedBytes[bucket] += bytesOf(block);
+            block->next = freeLists[bucket];
+            freeLists[bucket] = block;
+            return;
+        }
+        ++stats.freed;
+    }
+    // Unmapping can take a while; not under the lock
+    destroy(block);
+}
+
+void BufferPool::recordCopy(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.bytesCopied += bytes;
+}
+
+void BufferPool::trim() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for(size_t bucket = 0; bucket < buckets; ++bucket) {
+        Block*& head = freeLists[bucket];
+        while(head) {
+            Block* next = head->next;
+            destroy(head);
+            head = next;
+        }
+        cachedBytes[bucket] = 0;
+    }
+}
+
+BufferPool::Stats BufferPool::snapshot() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+Buffer Buffer::slice(size_t off, size_t len) const {
+    if(off > length || len > length - off)
+        throw std::out_of_range("Buffer::slice out of range");
+    retain();
+    return Buffer(block, offset + off, len);
+}
+
+// Copies just this view's range into a fresh block
+void Buffer::unshare() {
+    BufferPool& pool = *block->pool;
+    BufferPool::Block* fresh = pool.acquire(length);
+    std::memcpy(fresh->data(), data(), length * sizeof(int));
+    pool.recordCopy(length * sizeof(int));
+    drop();
+    block = fresh;
+    offset = 0;
+}
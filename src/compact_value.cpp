@@ -0,0 +1,44 @@
+#include "compact_value.h"
+
+#include <limits>
+#include <stdexcept>
+
+const char* StringArena::store(std::string_view s) {
+    if(s.size() > chunkSize / 4) {
+        // Large strings get their own allocation so chunks stay dense
+        large.push_back(std::make_unique<char[]>(s.size()));
+        std::memcpy(large.back().get(), s.data(), s.size());
+        largeBytes += s.size();
+        return large.back().get();
+    }
+    if(chunkUsed + s.size() > chunkSize) {
+        chunks.push_back(std::make_unique<char[]>(chunkSize));
+        chunkUsed = 0;
+    }
+    char* dst = chunks.back().get() + chunkUsed;
+    std::memcpy(dst, s.data(), s.size());
+    chunkUsed += s.size();
+    return dst;
+}
+
+uint32_t StringArena::intern(std::string_view s) {
+    auto it = lookup.find(s);
+    if(it != lookup.end())
+        return it->second;
+    
+    // Every uint32_t is a valid handle, so the last one issued is 2^32 - 1
+    if(strings.size() > std::numeric_limits<uint32_t>::max())
+        throw std::length_error("StringArena: out of 32-bit handles");
+    std::string_view stored(store(s), s.size());
+    uint32_t handle = static_cast<uint32_t>(strings.size());
+    strings.push_back(stored);
+    lookup.emplace(stored, handle);
+    return handle;
+}
+
+size_t StringArena::memoryUsage() const {
+    return chunks.size() * chunkSize + largeBytes
+         + strings.capacity() * sizeof(std::string_view)
+         + lookup.bucket_count() * sizeof(void*)
+         + lookup.size() * (sizeof(std::string_view) + sizeof(uint32_t) + 2 * sizeof(void*));
+}
@@ -0,0 +1,64 @@
+#include "cpu_dispatch.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+namespace cpu {
+
+namespace {
+
+Isa probe() {
+#if DOOKU_X86_KERNELS
+    // __builtin_cpu_supports also checks that the OS saves the wider
+    // registers (XCR0), not just the CPUID bits
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+       && __builtin_cpu_supports("avx512vl"))
+        return Isa::AVX512;
+    if(__builtin_cpu_supports("avx2"))
+        return Isa::AVX2;
+#endif
+    return Isa::Scalar;
+}
+
+Isa fromEnvironment(Isa best) {
+    const char* value = std::getenv("DOOKU_ISA");
+    if(!value || !*value)
+        return best;
+    
+    for(Isa isa : {Isa::Scalar, Isa::AVX2, Isa::AVX512}) {
+        if(std::strcmp(value, name(isa)) != 0)
+            continue;
+        if(isa > best) {
+            std::fprintf(stderr, "DOOKU_ISA=%s: not supported here, using %s\n", value, name(best));
+            return best;
+        }
+        return isa;
+    }
+    std::fprintf(stderr, "DOOKU_ISA=%s: expected scalar, avx2 or avx512\n", value);
+    return best;
+}
+
+}
+
+const char* name(Isa isa) {
+    switch(isa) {
+    case Isa::AVX512: return "avx512";
+    case Isa::AVX2: return "avx2";
+    default: return "scalar";
+    }
+}
+
+Isa detected() {
+    static const Isa isa = probe();
+    return isa;
+}
+
+Isa active() {
+    static const Isa isa = fromEnvironment(detected());
+    return isa;
+}
+
+}
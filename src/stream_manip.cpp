@@ -0,0 +1,149 @@
+#include "stream_manip.h"
+
+#include <algorithm>
+#include <string>
+#if DOOKU_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+std::ostream& operator<<(std::ostream& os, const binary_manip& bm) {
+    std::string result;
+    int val = bm.value;
+    
+    if(val == 0) result = "0";
+    else {
+        while(val > 0) {
+            result = (val % 2 ? "1" : "0") + result;
+            val /= 2;
+        }
+    }
+    
+    os << "0b" << result;
+    return os;
+}
+
+binary_manip binary(int v) { return binary_manip(v); }
+
+width_wrapper width(int w, char fill) { return width_wrapper(w, fill); }
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+const char* findNonSpaceScalar(const char* first, const char* last) {
+    while(first != last && isSpace(*first))
+        ++first;
+    return first;
+}
+
+#if DOOKU_X86_KERNELS
+
+DOOKU_TARGET_AVX2 const char* findNonSpaceAvx2(const char* first, const char* last) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i controls = _mm256_set1_epi8('\r' - '\t');
+    for(; last - first >= 32; first += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        // \t..\r: byte - '\t' <= 4 unsigned, i.e. min(d, 4) == d
+        __m256i offset = _mm256_sub_epi8(bytes, tab);
+        __m256i blank = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, space),
+                                        _mm256_cmpeq_epi8(_mm256_min_epu8(offset, controls), offset));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(blank));
+        if(mask != ~0u)
+            return first + __builtin_ctz(~mask);
+    }
+    return findNonSpaceScalar(first, last);
+}
+
+DOOKU_TARGET_AVX512 const char* findNonSpaceAvx512(const char* first, const char* last) {
+    const __m512i space = _mm512_set1_epi8(' ');
+    const __m512i tab = _mm512_set1_epi8('\t');
+    const __m512i controls = _mm512_set1_epi8('\r' - '\t');
+    auto blank = [&](__m512i bytes) DOOKU_TARGET_AVX512 {
+        return _mm512_cmpeq_epi8_mask(bytes, space)
+             | _mm512_cmple_epu8_mask(_mm512_sub_epi8(bytes, tab), controls);
+    };
+    for(; last - first >= 64; first += 64) {
+        __mmask64 mask = blank(_mm512_loadu_si512(first));
+        if(mask != ~__mmask64(0))
+            return first + __builtin_ctzll(~mask);
+    }
+    // Masked-off bytes of the last load are never touched, so it cannot
+    // fault past the end
+    __mmask64 valid = (__mmask64(1) << (last - first)) - 1;
+    __mmask64 mask = blank(_mm512_maskz_loadu_epi8(valid, first)) & valid;
+    return mask == valid ? last : first + __builtin_ctzll(~mask);
+}
+
+#endif
+
+}
+
+namespace kernels {
+
+#if DOOKU_X86_KERNELS
+const cpu::Kernel<FindNonSpace> find_non_space{findNonSpaceScalar, findNonSpaceAvx2, findNonSpaceAvx512};
+#else
+const cpu::Kernel<FindNonSpace> find_non_space{findNonSpaceScalar};
+#endif
+
+}
+
+const char* find_non_space(const char* first, const char* last) {
+    static const kernels::FindNonSpace find = kernels::find_non_space.select(cpu::active());
+    return find(first, last);
+}
+
+std::istream& operator>>(std::istream& is, const skip_whitespace&) {
+    using traits = std::istream::traits_type;
+    // Same state handling as the peek() this replaces: fails on a stream
+    // that is not good, sets eofbit when the input runs out
+    std::istream::sentry ok(is, true);
+    if(!ok)
+        return is;
+    
+    // Short runs go a character at a time. Longer ones copy what is
+    // already buffered (in_avail) into a window with sgetn, scan it with
+    // find_non_space and put the overshoot back with sungetc. Windows start
+    // small and double, so the overshoot stays proportional to the run.
+    constexpr int stepped = 2;
+    constexpr std::streamsize maxWindow = 512;
+    char window[maxWindow];
+    std::streamsize size = 16;
+    std::streambuf* buf = is.rdbuf();
+    try {
+        for(int skipped = 0;; ++skipped) {
+            traits::int_type c = buf->sgetc();
+            if(traits::eq_int_type(c, traits::eof())) {
+                is.setstate(std::ios_base::eofbit);
+                break;
+            }
+            if(!isSpace(traits::to_char_type(c)))
+                break;
+            
+            // Unbuffered streambufs report nothing available
+            std::streamsize n = skipped < stepped ? 0 : std::min(buf->in_avail(), size);
+            if(n < 2) {
+                buf->sbumpc();
+                continue;
+            }
+            n = buf->sgetn(window, n);
+            const char* stop = find_non_space(window, window + n);
+            // Read from the get area just now, so the put-back space is there
+            for(auto back = window + n - stop; back > 0; --back) {
+                if(traits::eq_int_type(buf->sungetc(), traits::eof())) {
+                    is.setstate(std::ios_base::badbit);
+                    return is;
+                }
+            }
+            if(stop != window + n)
+                break;
+            size = std::min(size * 2, maxWindow);
+        }
+    } catch(...) {
+        is.setstate(std::ios_base::badbit);
+    }
+    return is;
+}
@@ -0,0 +1,364 @@
+#include "trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace trace {
+
+namespace {
+
+// Buffers of exited threads move to `idle`. Their events stay exportable
+// until the next start(); an idle buffer holding none is handed to the
+// next thread that attaches, so short-lived threads don't grow the list.
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<ThreadBuffer*> idle;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+// Tick <-> steady_clock calibration taken at start() and stop()
+struct Clock {
+    uint64_t ticks;
+    std::chrono::steady_clock::time_point time;
+    
+    static Clock sample() {
+        return Clock{now(), std::chrono::steady_clock::now()};
+    }
+};
+
+Clock origin;
+Clock finish;
+bool stopped = true;
+
+double nanosPerTick() {
+    Clock end = stopped ? finish : Clock::sample();
+    if(end.ticks <= origin.ticks)
+        return 1.0;
+    double ns = std::chrono::duration<double, std::nano>(end.time - origin.time).count();
+    return ns / static_cast<double>(end.ticks - origin.ticks);
+}
+
+struct Recorded {
+    uint32_t tid;
+    Event event;
+};
+
+std::vector<Recorded> collect() {
+    std::vector<Recorded> events;
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    for(const auto& buffer : registry().buffers) {
+        for(Chunk* c = buffer->head; c; c = c->next.load(std::memory_order_acquire)) {
+            size_t n = c->count.load(std::memory_order_acquire);
+            for(size_t i = 0; i < n; ++i)
+                events.push_back(Recorded{buffer->tid, c->events[i]});
+        }
+    }
+    return events;
+}
+
+std::string category(const char* name) {
+    std::string s = name;
+    size_t pos = s.find("::");
+    return pos == std::string::npos ? s : s.substr(0, pos);
+}
+
+// Log2 buckets of nanoseconds plus exact percentiles
+class Histogram {
+private:
+    std::vector<double> values;
+    
+    static std::string formatNs(double ns) {
+        char text[32];
+        if(ns < 1e3)
+            std::snprintf(text, sizeof(text), "%.0fns", ns);
+        else if(ns < 1e6)
+            std::snprintf(text, sizeof(text), "%.1fus", ns / 1e3);
+        else if(ns < 1e9)
+            std::snprintf(text, sizeof(text), "%.1fms", ns / 1e6);
+        else
+            std::snprintf(text, sizeof(text), "%.2fs", ns / 1e9);
+        return text;
+    }
+
+public:
+    void add(double ns) { values.push_back(ns); }
+    
+    void print(std::ostream& out, const std::string& name) {
+        std::sort(values.begin(), values.end());
+        auto at = [&](double p) {
+            return values[static_cast<size_t>(p / 100.0 * (values.size() - 1))];
+        };
+        double total = 0;
+        for(double v : values)
+            total += v;
+        
+        out << name << "  count " << values.size()
+            << "  mean " << formatNs(total / values.size())
+            << "  p50 " << formatNs(at(50)) << "  p90 " << formatNs(at(90))
+            << "  p99 " << formatNs(at(99)) << "  max " << formatNs(values.back()) << "\n";
+        
+        std::map<int, size_t> buckets;
+        for(double v : values)
+            ++buckets[v < 1 ? 0 : static_cast<int>(std::log2(v))];
+        size_t peak = 0;
+        for(const auto& [bucket, count] : buckets)
+            peak = std::max(peak, count);
+        for(const auto& [bucket, count] : buckets) {
+            std::string range = formatNs(std::ldexp(1.0, bucket)) + "-" + formatNs(std::ldexp(1.0, bucket + 1));
+            size_t bar = std::max<size_t>(1, count * 40 / peak);
+            char line[128];
+            std::snprintf(line, sizeof(line), "    %-16s %-40s %zu\n",
+                          range.c_str(), std::string(bar, '#').c_str(), count);
+            out << line;
+        }
+    }
+};
+
+bool empty(const ThreadBuffer* buffer) {
+    return !buffer->head || buffer->head->count.load(std::memory_order_relaxed) == 0;
+}
+
+void freeChunks(ThreadBuffer* buffer) {
+    for(Chunk* c = buffer->head; c;) {
+        Chunk* next = c->next.load(std::memory_order_relaxed);
+        delete c;
+        c = next;
+    }
+    buffer->head = buffer->tail = nullptr;
+}
+
+// Set before the thread has a buffer; see setThreadName
+thread_local const char* pendingName = nullptr;
+
+// Hands the thread's buffer back at thread exit
+struct Detach {
+    ~Detach() {
+        if(!detail::current)
+            return;
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        registry().idle.push_back(detail::current);
+        detail::current = nullptr;
+    }
+};
+
+thread_local Detach detachAtExit;
+
+}
+
+namespace detail {
+
+ThreadBuffer* attach() {
+    Registry& r = registry();
+    // First use constructs it, registering the thread-exit hook
+    static_cast<void>(&detachAtExit);
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto reusable = std::find_if(r.idle.begin(), r.idle.end(), empty);
+    if(reusable != r.idle.end()) {
+        current = *reusable;
+        r.idle.erase(reusable);
+    } else {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->tid = static_cast<uint32_t>(r.buffers.size() + 1);
+        current = buffer.get();
+        r.buffers.push_back(std::move(buffer));
+    }
+    current->name.store(pendingName, std::memory_order_relaxed);
+    return current;
+}
+
+// Moves to the next chunk, reusing chunks left over from a previous session
+Chunk* grow(ThreadBuffer* buffer) {
+    Chunk* next = buffer->tail ? buffer->tail->next.load(std::memory_order_relaxed) : buffer->head;
+    if(!next) {
+        next = new Chunk;
+        if(buffer->tail)
+            buffer->tail->next.store(next, std::memory_order_release);
+        else {
+            std::lock_guard<std::mutex> lock(registry().mutex);
+            buffer->head = next;
+        }
+    }
+    next->count.store(0, std::memory_order_relaxed);
+    buffer->tail = next;
+    return next;
+}
+
+}
+
+// Doesn't attach: a thread that never records needs no buffer
+void setThreadName(const char* name) {
+    pendingName = name;
+    if(ThreadBuffer* buffer = detail::current)
+        buffer->name.store(name, std::memory_order_relaxed);
+}
+
+void start() {
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        // Exited threads' events are dropped with their chunks; the rest
+        // keep theirs for reuse
+        for(ThreadBuffer* buffer : registry().idle)
+            freeChunks(buffer);
+        for(const auto& buffer : registry().buffers) {
+            for(Chunk* c = buffer->head; c; c = c->next.load(std::memory_order_relaxed))
+                c->count.store(0, std::memory_order_relaxed);
+            buffer->tail = buffer->head;
+        }
+    }
+    origin = Clock::sample();
+    stopped = false;
+    detail::active.store(true, std::memory_order_release);
+}
+
+void stop() {
+    detail::active.store(false, std::memory_order_release);
+    finish = Clock::sample();
+    stopped = true;
+}
+
+size_t eventCount() {
+    size_t total = 0;
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    for(const auto& buffer : registry().buffers)
+        for(Chunk* c = buffer->head; c; c = c->next.load(std::memory_order_acquire))
+            total += c->count.load(std::memory_order_acquire);
+    return total;
+}
+
+bool writeChrome(const char* path) {
+    std::FILE* out = std::fopen(path, "w");
+    if(!out)
+        return false;
+    
+    const double scale = nanosPerTick() / 1000.0;    // ticks -> microseconds
+    auto micros = [&](uint64_t ticks) {
+        return ticks < origin.ticks ? 0.0 : (ticks - origin.ticks) * scale;
+    };
+    
+    std::fprintf(out, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    bool first = true;
+    auto separator = [&] {
+        std::fputs(first ? "" : ",\n", out);
+        first = false;
+    };
+    
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        for(const auto& buffer : registry().buffers) {
+            const char* name = buffer->name.load(std::memory_order_relaxed);
+            separator();
+            if(name)
+                std::fprintf(out, "{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": %u, "
+                             "\"args\": {\"name\": \"%s\"}}", buffer->tid, name);
+            else
+                std::fprintf(out, "{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": %u, "
+                             "\"args\": {\"name\": \"thread %u\"}}", buffer->tid, buffer->tid);
+        }
+    }
+    
+    for(const auto& [tid, e] : collect()) {
+        std::string cat = category(e.name);
+        double ts = micros(e.ts);
+        separator();
+        switch(e.phase) {
+        case Phase::Complete:
+            std::fprintf(out, "{\"ph\": \"X\", \"name\": \"%s\", \"cat\": \"%s\", \"pid\": 1, \"tid\": %u, "
+                         "\"ts\": %.3f, \"dur\": %.3f, \"args\": {\"arg\": %llu}}",
+                         e.name, cat.c_str(), tid, ts, e.value * scale, (unsigned long long)e.arg);
+            break;
+        case Phase::Instant:
+            std::fprintf(out, "{\"ph\": \"i\", \"s\": \"t\", \"name\": \"%s\", \"cat\": \"%s\", \"pid\": 1, "
+                         "\"tid\": %u, \"ts\": %.3f, \"args\": {\"arg\": %llu}}",
+                         e.name, cat.c_str(), tid, ts, (unsigned long long)e.arg);
+            break;
+        case Phase::Counter:
+            std::fprintf(out, "{\"ph\": \"C\", \"name\": \"%s\", \"cat\": \"%s\", \"id\": \"%llx\", "
+                         "\"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"args\": {\"value\": %llu}}",
+                         e.name, cat.c_str(), (unsigned long long)e.arg, tid, ts, (unsigned long long)e.value);
+            break;
+        case Phase::FlowBegin:
+        case Phase::FlowEnd:
+            // A zero-length slice for the flow arrow to bind to
+            std::fprintf(out, "{\"ph\": \"X\", \"name\": \"%s\", \"cat\": \"%s\", \"pid\": 1, \"tid\": %u, "
+                         "\"ts\": %.3f, \"dur\": 0},\n"
+                         "{\"ph\": \"%s\", \"name\": \"flow\", \"cat\": \"%s\", \"id\": %llu, "
+                         "\"pid\": 1, \"tid\": %u, \"ts\": %.3f%s}",
+                         e.name, cat.c_str(), tid, ts,
+                         e.phase == Phase::FlowBegin ? "s" : "f", cat.c_str(),
+                         (unsigned long long)e.value, tid, ts,
+                         e.phase == Phase::FlowEnd ? ", \"bp\": \"e\"" : "");
+            break;
+        }
+    }
+    std::fprintf(out, "\n]}\n");
+    return std::fclose(out) == 0;
+}
+
+void printSummary(std::ostream& out) {
+    const double scale = nanosPerTick();
+    std::map<std::string, Histogram> latencies;
+    std::map<std::string, size_t> instants;
+    std::map<std::string, std::pair<uint64_t, uint64_t>> counters;    // last, max
+    std::unordered_map<uint64_t, Event> openFlows;
+    
+    // Events are grouped by thread, so order flows by time before matching
+    std::vector<Recorded> events = collect();
+    std::stable_sort(events.begin(), events.end(), [](const Recorded& a, const Recorded& b) {
+        return a.event.ts < b.event.ts;
+    });
+    
+    for(const auto& [tid, e] : events) {
+        switch(e.phase) {
+        case Phase::Complete:
+            latencies[e.name].add(e.value * scale);
+            break;
+        case Phase::Instant:
+            ++instants[e.name];
+            break;
+        case Phase::Counter: {
+            auto& [last, peak] = counters[e.name];
+            last = e.value;
+            peak = std::max(peak, e.value);
+            break;
+        }
+        case Phase::FlowBegin:
+            openFlows[e.value] = e;
+            break;
+        case Phase::FlowEnd: {
+            auto it = openFlows.find(e.value);
+            if(it == openFlows.end())
+                break;
+            const Event& begin = it->second;
+            std::string name = std::string(begin.name) + " -> " + e.name;
+            latencies[name].add(e.ts > begin.ts ? (e.ts - begin.ts) * scale : 0);
+            openFlows.erase(it);
+            break;
+        }
+        }
+    }
+    
+    out << "trace summary: " << events.size() << " events\n";
+    for(auto& [name, histogram] : latencies)
+        histogram.print(out, name);
+    for(const auto& [name, count] : instants)
+        out << name << "  count " << count << "\n";
+    for(const auto& [name, values] : counters)
+        out << name << "  last " << values.first << "  max " << values.second << "\n";
+    if(!openFlows.empty())
+        out << openFlows.size() << " flows never completed\n";
+}
+
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal checks for the ctest executables. Unlike assert they stay on in
+// Release builds; a failed check reports and the test exits non-zero.
+namespace check {
+
+inline int failures = 0;
+
+inline void fail(const char* expr, const char* file, int line) {
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+    ++failures;
+}
+
+inline int result() {
+    if(failures)
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
+
+}
+
+#define CHECK(expr) ((expr) ? void() : check::fail(#expr, __FILE__, __LINE__))
@@ -0,0 +1,124 @@
+#include "check.h"
+#include "backing_store.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+constexpr size_t hugePageSize = 2 * 1024 * 1024;
+
+// Zero-filled at both ends, and every page writable
+bool zeroedAndWritable(const Backing& b) {
+    auto* p = static_cast<unsigned char*>(b.data());
+    if(!p || p[0] != 0 || p[b.size() / 2] != 0 || p[b.size() - 1] != 0)
+        return false;
+    for(size_t off = 0; off < b.size(); off += 4096)
+        p[off] = 0xab;
+    p[b.size() - 1] = 0xcd;
+    return p[0] == 0xab && p[b.size() - 1] == 0xcd;
+}
+
+void heapBlocks() {
+    Backing b = Backing::allocate(1000);
+    CHECK(b.kind() == Backing::HeapMemory);
+    CHECK(b.size() == 1000);
+    CHECK(b.pageMode() == BackingOptions::SmallPages);
+    CHECK(zeroedAndWritable(b));
+    
+    Backing empty = Backing::allocate(0);
+    CHECK(empty.kind() == Backing::None);
+    CHECK(!empty.data() && empty.size() == 0);
+}
+
+void smallPageMappings() {
+    for(bool populate : {false, true}) {
+        Backing b = Backing::allocate(100'001, {BackingOptions::Mapped, BackingOptions::SmallPages, populate});
+        CHECK(b.kind() == Backing::AnonymousMapping);
+        CHECK(b.size() == 100'001);
+        CHECK(b.pageMode() == BackingOptions::SmallPages);
+        CHECK(zeroedAndWritable(b));
+    }
+}
+
+// Huge page requests start on a huge page boundary; explicit ones fall
+// back to transparent huge pages when no pool is reserved
+void hugePageMappings() {
+    for(auto pages : {BackingOptions::TransparentHugePages, BackingOptions::ExplicitHugePages}) {
+        for(bool populate : {false, true}) {
+            Backing b = Backing::allocate(3 * 1024 * 1024 + 5, {BackingOptions::Mapped, pages, populate});
+            CHECK(b.kind() == Backing::AnonymousMapping);
+            CHECK(b.size() == 3 * 1024 * 1024 + 5);
+            CHECK(b.pageMode() == pages || b.pageMode() == BackingOptions::TransparentHugePages);
+            CHECK(reinterpret_cast<uintptr_t>(b.data()) % hugePageSize == 0);
+            CHECK(zeroedAndWritable(b));
+        }
+    }
+}
+
+void moveTransfersOwnership() {
+    Backing a = Backing::allocate(5000, {BackingOptions::Mapped});
+    void* p = a.data();
+    Backing b = std::move(a);
+    CHECK(b.data() == p && b.size() == 5000);
+    CHECK(!a.data() && a.kind() == Backing::None);
+    
+    a = Backing::allocate(10);
+    a = std::move(b);
+    CHECK(a.data() == p && a.kind() == Backing::AnonymousMapping);
+}
+
+std::string readFile(const char* path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Contents come back as written; writes through the mapping stay private
+void mapFileRoundTrip() {
+    const char* path = "test_backing_store.bin";
+    std::string contents;
+    for(int i = 0; i < 10'000; ++i)
+        contents.push_back(static_cast<char>(i * 7));
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(contents.data(), contents.size());
+    }
+    
+    for(bool populate : {false, true}) {
+        Backing b = Backing::mapFile(path, populate);
+        CHECK(b.kind() == Backing::FileMapping);
+        CHECK(b.size() == contents.size());
+        CHECK(std::memcmp(b.data(), contents.data(), contents.size()) == 0);
+        static_cast<char*>(b.data())[0] = 'x';
+    }
+    CHECK(readFile(path) == contents);
+    
+    { std::ofstream truncate(path, std::ios::binary); }
+    CHECK(Backing::mapFile(path).kind() == Backing::None);
+    std::remove(path);
+    
+    bool missing = false;
+    try {
+        Backing::mapFile(path);
+    } catch(const std::runtime_error&) {
+        missing = true;
+    }
+    CHECK(missing);
+}
+
+}
+
+int main() {
+    heapBlocks();
+    smallPageMappings();
+    hugePageMappings();
+    moveTransfersOwnership();
+    mapFileRoundTrip();
+    return check::result();
+}
@@ -0,0 +1,68 @@
+#include "check.h"
+#include "buffer.h"
+
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+bool throwsLengthError(BufferPool& pool, size_t size) {
+    try {
+        Buffer b(size, pool);
+    } catch(const std::length_error&) {
+        return true;
+    }
+    return false;
+}
+
+// Heap blocks only, with the mapping threshold out of reach
+void retentionCap() {
+    BufferPool pool(std::numeric_limits<size_t>::max(), {}, 64 * 1024);
+    {
+        // 16 KiB blocks: four fit under the 64 KiB cap, the fifth is freed
+        std::vector<Buffer> held;
+        for(int i = 0; i < 5; ++i)
+            held.emplace_back(4096, pool);
+    }
+    BufferPool::Stats stats = pool.snapshot();
+    CHECK(stats.allocations == 5);
+    CHECK(stats.freed == 1);
+    
+    {
+        std::vector<Buffer> held;
+        for(int i = 0; i < 5; ++i)
+            held.emplace_back(4096, pool);
+    }
+    stats = pool.snapshot();
+    CHECK(stats.reuses == 4);
+    CHECK(stats.allocations == 6);
+    CHECK(stats.freed == 2);
+    
+    // A block bigger than the whole cap is never cached
+    { Buffer big(64 * 1024, pool); }
+    { Buffer big(64 * 1024, pool); }
+    stats = pool.snapshot();
+    CHECK(stats.allocations == 8);
+    CHECK(stats.freed == 4);
+}
+
+void sizeLimits() {
+    BufferPool pool;
+    CHECK(throwsLengthError(pool, std::numeric_limits<size_t>::max()));
+    CHECK(throwsLengthError(pool, size_t(1) << 63));
+    CHECK(throwsLengthError(pool, (size_t(1) << 53) + 1));
+    
+    Buffer empty(0, pool);
+    Buffer one(1, pool);
+    CHECK(empty.size() == 0);
+    CHECK(one.size() == 1);
+}
+
+}
+
+int main() {
+    retentionCap();
+    sizeLimits();
+    return check::result();
+}
@@ -0,0 +1,79 @@
+#include "check.h"
+#include "compact_value.h"
+
+#include <string>
+#include <string_view>
+
+namespace {
+
+// 15 characters fit in the value itself; 16 go to the arena
+void inlineBoundary() {
+    StringArena arena;
+    std::string fifteen(15, 'a');
+    std::string sixteen(16, 'b');
+    
+    CompactValue inlined(fifteen, arena);
+    CHECK(inlined.isString());
+    CHECK(arena.count() == 0);
+    CHECK(inlined.asString(arena) == fifteen);
+    
+    CompactValue interned(sixteen, arena);
+    CHECK(interned.isString());
+    CHECK(arena.count() == 1);
+    CHECK(interned.asString(arena) == sixteen);
+    
+    CompactValue empty(std::string_view(), arena);
+    CHECK(empty.isString() && empty.asString(arena).empty());
+    CHECK(arena.count() == 1);
+}
+
+void equality() {
+    StringArena arena;
+    std::string longText = "a string too long to be stored inline";
+    
+    // Equal long strings intern to one handle, so they compare equal
+    // through the 16-byte compare
+    std::string copy = longText;
+    CHECK(CompactValue(longText, arena) == CompactValue(copy, arena));
+    CHECK(arena.count() == 1);
+    CHECK(CompactValue(longText, arena) != CompactValue(longText + "!", arena));
+    
+    CHECK(CompactValue("short", arena) == CompactValue(std::string("short"), arena));
+    CHECK(CompactValue("short", arena) != CompactValue("shorT", arena));
+    CHECK(CompactValue(std::string(15, 'x'), arena) != CompactValue(std::string(16, 'x'), arena));
+    
+    // Different types never compare equal, even with the same numeric value
+    CHECK(CompactValue(1) == CompactValue(1));
+    CHECK(CompactValue(1) != CompactValue(1.0));
+    CHECK(CompactValue(1) != CompactValue("1", arena));
+    CHECK(CompactValue(0) != CompactValue("", arena));
+    
+    // Doubles compare by value: 0.0 == -0.0
+    CHECK(CompactValue(0.0) == CompactValue(-0.0));
+    CHECK(CompactValue(2.5) != CompactValue(3.5));
+}
+
+void visitEachType() {
+    StringArena arena;
+    std::string longText(40, 'z');
+    CompactValue values[] = {CompactValue(7), CompactValue(2.5), CompactValue("inline", arena),
+                             CompactValue(longText, arena)};
+    std::string seen;
+    for(const auto& v : values) {
+        seen += visit(overload{
+            [](int i) { return "int:" + std::to_string(i) + ";"; },
+            [](double d) { return "double:" + std::to_string(d) + ";"; },
+            [](std::string_view s) { return "string:" + std::to_string(s.size()) + ";"; },
+        }, v, arena);
+    }
+    CHECK(seen == "int:7;double:2.500000;string:6;string:40;");
+}
+
+}
+
+int main() {
+    inlineBoundary();
+    equality();
+    visitEachType();
+    return check::result();
+}
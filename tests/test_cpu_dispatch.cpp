@@ -0,0 +1,174 @@
+#include "check.h"
+#include "cpu_dispatch.h"
+#include "hashing.h"
+#include "reduce.h"
+#include "stream_manip.h"
+#include "vector_expr.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Every variant of every dispatched kernel this CPU supports, against the
+// scalar reference bit for bit, over sizes and offsets that reach each
+// variant's vector body, masked or scalar tail, and alignment fix-ups.
+// The variants are called directly, so DOOKU_ISA does not narrow this.
+namespace {
+
+template<typename T>
+bool sameBits(const T& a, const T& b) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+template<typename T>
+bool sameBits(const std::vector<T>& a, const std::vector<T>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+// call(fn) runs one variant and returns its result by value
+template<typename Fn, typename Call>
+bool matchesScalar(const cpu::Kernel<Fn>& kernel, Call&& call) {
+    auto reference = call(kernel.scalar);
+    for(cpu::Isa isa : {cpu::Isa::AVX2, cpu::Isa::AVX512}) {
+        Fn fn = kernel.variant(isa);
+        if(fn && cpu::supported(isa) && !sameBits(call(fn), reference))
+            return false;
+    }
+    return true;
+}
+
+std::vector<size_t> sizes() {
+    std::vector<size_t> n;
+    for(size_t i = 0; i <= 70; ++i)
+        n.push_back(i);
+    for(size_t i : {127, 128, 129, 255, 256, 257, 511, 513, 1000, 4099, 10'007})
+        n.push_back(i);
+    return n;
+}
+
+void sums() {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+    std::uniform_int_distribution<int> exponent(-30, 30);
+    std::vector<double> doubles(10'007 + 3);
+    std::vector<int> ints(doubles.size());
+    for(size_t i = 0; i < doubles.size(); ++i) {
+        doubles[i] = std::ldexp(mantissa(rng), exponent(rng));
+        ints[i] = static_cast<int>(rng());
+    }
+    std::vector<float> floats(doubles.begin(), doubles.end());
+    
+    for(size_t n : sizes()) {
+        for(size_t offset = 0; offset < 3; ++offset) {
+            CHECK(matchesScalar(kernels::sum_double, [&](kernels::SumDouble sum) {
+                return sum(doubles.data() + offset, n);
+            }));
+            CHECK(matchesScalar(kernels::sum_float, [&](kernels::SumFloat sum) {
+                return sum(floats.data() + offset, n);
+            }));
+            CHECK(matchesScalar(kernels::sum_int, [&](kernels::SumInt sum) {
+                return sum(ints.data() + offset, n);
+            }));
+        }
+    }
+}
+
+void vectorSums() {
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<double> dist(-1e6, 1e6);
+    constexpr size_t maxOperands = 6;
+    std::vector<std::vector<double>> columns(maxOperands, std::vector<double>(1001 + 1));
+    for(auto& column : columns)
+        for(auto& v : column)
+            v = dist(rng);
+    
+    for(size_t count = 1; count <= maxOperands; ++count) {
+        for(size_t n : {0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 33, 1001}) {
+            const double* operands[maxOperands];
+            for(size_t k = 0; k < count; ++k)
+                operands[k] = columns[k].data() + (k % 2);
+            CHECK(matchesScalar(kernels::vector_sum, [&](kernels::VectorSumN sum) {
+                std::vector<double> out(n);
+                sum(out.data(), operands, count, n);
+                return out;
+            }));
+            
+            // Written over its first operand, as v = v + w does
+            CHECK(matchesScalar(kernels::vector_sum, [&](kernels::VectorSumN sum) {
+                std::vector<double> out(columns[0].begin(), columns[0].begin() + n);
+                const double* aliased[maxOperands];
+                for(size_t k = 0; k < count; ++k)
+                    aliased[k] = k == 0 ? out.data() : operands[k];
+                sum(out.data(), aliased, count, n);
+                return out;
+            }));
+        }
+    }
+}
+
+void batchHashes() {
+    std::mt19937 rng(3);
+    std::vector<std::string> strings(200);
+    for(auto& s : strings) {
+        s.resize(rng() % 41);
+        for(auto& c : s)
+            c = static_cast<char>(rng());
+    }
+    // Equal lengths too, which keep every lane busy to the end
+    std::vector<std::string> even(40, std::string(16, 'x'));
+    for(size_t i = 0; i < even.size(); ++i)
+        even[i][i % 16] = static_cast<char>(i);
+    
+    for(const auto* set : {&strings, &even}) {
+        std::vector<std::string_view> keys(set->begin(), set->end());
+        for(size_t n = 0; n <= keys.size(); n += n < 40 ? 1 : 37) {
+            CHECK(matchesScalar(kernels::fnv1a_hash_many, [&](kernels::HashMany hash) {
+                std::vector<uint32_t> out(n);
+                hash(keys.data(), n, out.data());
+                return out;
+            }));
+        }
+    }
+}
+
+// From every start position, through runs of all six C-locale blanks
+// and bytes that are only spaces in other locales
+void nonSpaceScans() {
+    std::mt19937 rng(4);
+    static const char blanks[] = " \t\n\v\f\r";
+    std::string text;
+    while(text.size() < 2000) {
+        size_t gap = rng() % 80;
+        for(size_t i = 0; i < gap; ++i)
+            text.push_back(blanks[rng() % 6]);
+        text.push_back("x\x85\xa0\x1c"[rng() % 4]);
+    }
+    text.append(100, ' ');
+    
+    const char* first = text.data();
+    const char* last = first + text.size();
+    for(size_t start = 0; start < text.size(); ++start) {
+        CHECK(matchesScalar(kernels::find_non_space, [&](kernels::FindNonSpace find) {
+            return find(first + start, last) - first;
+        }));
+    }
+    CHECK(matchesScalar(kernels::find_non_space, [&](kernels::FindNonSpace find) {
+        return find(last, last) - first;
+    }));
+}
+
+}
+
+int main() {
+    sums();
+    vectorSums();
+    batchHashes();
+    nonSpaceScans();
+    return check::result();
+}
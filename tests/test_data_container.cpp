@@ -0,0 +1,241 @@
+#include "check.h"
+#include "data_container.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// RadixSort against std::sort with the same order. Compared with == since
+// the radix order puts -0.0 before 0.0 where std::sort keeps them as found.
+template<typename T, typename Order>
+bool sortsLikeStdSort(std::vector<T> values) {
+    std::vector<T> expected = values;
+    std::sort(expected.begin(), expected.end(), Order{});
+    RadixSort<Order>{}.sort(values);
+    return values == expected;
+}
+
+template<typename T>
+void checkBothOrders(const std::vector<T>& values) {
+    CHECK((sortsLikeStdSort<T, AscendingSort>(values)));
+    CHECK((sortsLikeStdSort<T, DescendingSort>(values)));
+}
+
+template<typename T>
+std::vector<T> randomValues(std::mt19937_64& rng, size_t n, T low, T high) {
+    std::vector<T> values(n);
+    if constexpr (std::is_floating_point_v<T>) {
+        std::uniform_real_distribution<T> dist(low, high);
+        for(auto& v : values)
+            v = dist(rng);
+    } else {
+        std::uniform_int_distribution<T> dist(low, high);
+        for(auto& v : values)
+            v = dist(rng);
+    }
+    return values;
+}
+
+void radixSortFloats() {
+    std::mt19937_64 rng(66);
+    checkBothOrders(randomValues<float>(rng, 10'000, -1e6f, 1e6f));
+    checkBothOrders(randomValues<double>(rng, 10'000, -1e300, 1e300));
+    
+    // Negative values sort by inverted magnitude; -0.0 orders with 0.0
+    checkBothOrders(std::vector<double>{-0.5, 3.0, -2.0, -0.0, 0.0, -1e-300,
+                                        std::numeric_limits<double>::lowest(),
+                                        std::numeric_limits<double>::max(),
+                                        -std::numeric_limits<double>::infinity(),
+                                        std::numeric_limits<double>::infinity(),
+                                        std::numeric_limits<double>::denorm_min(), -1.0, 1.0});
+    checkBothOrders(std::vector<float>{-1.5f, -0.25f, 2.0f, 0.0f, -3e38f, 3e38f});
+}
+
+// 64-bit keys are the widest RadixSort takes: all eight digit passes
+void radixSortWidestIntegers() {
+    std::mt19937_64 rng(99);
+    checkBothOrders(randomValues<int64_t>(rng, 10'000, std::numeric_limits<int64_t>::min(),
+                                          std::numeric_limits<int64_t>::max()));
+    checkBothOrders(randomValues<uint64_t>(rng, 10'000, 0, std::numeric_limits<uint64_t>::max()));
+    checkBothOrders(std::vector<int64_t>{0, -1, 1, std::numeric_limits<int64_t>::min(),
+                                         std::numeric_limits<int64_t>::max(), -42, 42});
+    // uniform_int_distribution does not take 8-bit types
+    std::vector<int> small = randomValues<int>(rng, 1'000, -128, 127);
+    checkBothOrders(std::vector<int8_t>(small.begin(), small.end()));
+    checkBothOrders(randomValues<int16_t>(rng, 1'000, -30'000, 30'000));
+}
+
+void radixSortSmallInputs() {
+    checkBothOrders(std::vector<int>{});
+    checkBothOrders(std::vector<int>{7});
+    checkBothOrders(std::vector<int>(100, 5));
+}
+
+// BatchPrint output through a temporary file against SimplePrint's, with
+// std::cout captured; both go through DataContainer's header and trailer
+template<typename T>
+bool printsLikeSimplePrint(const std::vector<T>& values) {
+    DataContainer<T, AscendingSort, SimplePrint> simple;
+    for(const auto& v : values)
+        simple.add(v);
+    std::ostringstream captured;
+    std::streambuf* saved = std::cout.rdbuf(captured.rdbuf());
+    simple.print();
+    std::cout.rdbuf(saved);
+    
+    BatchPrint<> batch;
+    batch.out = std::tmpfile();
+    if(!batch.out)
+        return false;
+    batch.print(values);
+    std::string written(static_cast<size_t>(std::ftell(batch.out)), '\0');
+    std::rewind(batch.out);
+    size_t read = std::fread(written.data(), 1, written.size(), batch.out);
+    std::fclose(batch.out);
+    
+    if(read != written.size() || written != captured.str()) {
+        std::fprintf(stderr, "SimplePrint: %s\nBatchPrint:  %s\n", captured.str().c_str(), written.c_str());
+        return false;
+    }
+    return true;
+}
+
+void batchPrintMatchesSimplePrint() {
+    CHECK(printsLikeSimplePrint(std::vector<int>{}));
+    CHECK(printsLikeSimplePrint(std::vector<int>{0, -1, 42, std::numeric_limits<int>::min(),
+                                                 std::numeric_limits<int>::max()}));
+    CHECK(printsLikeSimplePrint(std::vector<uint64_t>{0, std::numeric_limits<uint64_t>::max()}));
+    CHECK(printsLikeSimplePrint(std::vector<double>{0.0, -0.0, 0.1, 1.5, -2.25, 1e6, 123456.0, 1234567.0,
+                                                    1e-5, 3.14159265358979, 1e300, -1e-300,
+                                                    std::numeric_limits<double>::infinity(),
+                                                    -std::numeric_limits<double>::infinity()}));
+    CHECK(printsLikeSimplePrint(std::vector<float>{0.5f, -3.75f, 1e10f, 16777217.0f}));
+    CHECK(printsLikeSimplePrint(std::vector<bool>{true, false, true}));
+    CHECK(printsLikeSimplePrint(std::vector<char>{'a', 'Z', '0', '!'}));
+    CHECK(printsLikeSimplePrint(std::vector<signed char>{'x', 'y'}));
+    CHECK(printsLikeSimplePrint(std::vector<unsigned char>{'p', 'q'}));
+    CHECK(printsLikeSimplePrint(std::vector<std::string>{"dooku", "", "order 66"}));
+}
+
+// Every chunk count from 2 to 7, so the merge rounds see odd runs left
+// over; sizes either side of two chunks' worth take both paths
+void parallelSortChunking() {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> dist(-1000, 1000);
+    for(size_t chunks = 2; chunks <= 7; ++chunks) {
+        for(size_t n : {0, 1, 63, 64, 65, 127, 128, 1000, 4099}) {
+            std::vector<int> data(n);
+            for(auto& v : data)
+                v = dist(rng);
+            std::vector<int> ascending = data;
+            std::vector<int> descending = data;
+            std::sort(ascending.begin(), ascending.end(), AscendingSort{});
+            std::sort(descending.begin(), descending.end(), DescendingSort{});
+            
+            std::vector<int> sorted = data;
+            ParallelSort<AscendingSort>{{}, 64, chunks}.sort(sorted);
+            CHECK(sorted == ascending);
+            sorted = data;
+            ParallelSort<DescendingSort>{{}, 64, chunks}.sort(sorted);
+            CHECK(sorted == descending);
+        }
+    }
+}
+
+// Append-then-sort rounds, including tails that belong before, after and
+// among what is already sorted
+template<typename Compare>
+void incrementalRounds() {
+    DataContainer<int, IncrementalSort<Compare>> container;
+    std::vector<int> expected;
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> dist(-500, 500);
+    const int offsets[] = {0, 10'000, -10'000, 0, 0};
+    for(int round = 0; round < 5; ++round) {
+        for(int i = 0; i < 50 * round; ++i) {
+            int v = dist(rng) + offsets[round];
+            container.add(v);
+            expected.push_back(v);
+        }
+        container.sort();
+        std::sort(expected.begin(), expected.end(), Compare{});
+        bool same = container.size() == expected.size();
+        for(size_t i = 0; same && i < expected.size(); ++i)
+            same = container.get(i) == expected[i];
+        CHECK(same);
+    }
+}
+
+void incrementalSortRounds() {
+    incrementalRounds<AscendingSort>();
+    incrementalRounds<DescendingSort>();
+}
+
+// Writers add disjoint ranges while a reader calls size() and sort(); at
+// the end every value is there exactly once, in order
+template<typename Policy>
+bool concurrentAddSizeSort() {
+    constexpr int writers = 4;
+    constexpr int perWriter = 5'000;
+    DataContainer<int, AscendingSort, SimplePrint, Policy> container;
+    
+    std::atomic<bool> done{false};
+    bool sizesValid = true;
+    std::thread reader([&] {
+        size_t last = 0;
+        while(!done.load()) {
+            size_t n = container.size();
+            sizesValid = sizesValid && n >= last && n <= size_t(writers) * perWriter;
+            last = n;
+            container.sort();
+        }
+    });
+    std::vector<std::thread> threads;
+    for(int w = 0; w < writers; ++w) {
+        threads.emplace_back([&container, w] {
+            // Descending within each writer so the sorts have work to do
+            for(int i = perWriter - 1; i >= 0; --i)
+                container.add(w * perWriter + i);
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+    done = true;
+    reader.join();
+    
+    container.sort();
+    if(!sizesValid || container.size() != size_t(writers) * perWriter)
+        return false;
+    for(size_t i = 0; i < container.size(); ++i) {
+        if(container.get(i) != static_cast<int>(i))
+            return false;
+    }
+    return true;
+}
+
+void threadingPolicies() {
+    CHECK(concurrentAddSizeSort<MultiThreaded>());
+    CHECK(concurrentAddSizeSort<ReaderWriterThreaded>());
+    CHECK(concurrentAddSizeSort<ShardedThreaded<int>>());
+}
+
+}
+
+int main() {
+    radixSortFloats();
+    radixSortWidestIntegers();
+    radixSortSmallInputs();
+    batchPrintMatchesSimplePrint();
+    parallelSortChunking();
+    incrementalSortRounds();
+    threadingPolicies();
+    return check::result();
+}
@@ -0,0 +1,107 @@
+#include "check.h"
+#include "memory_pool.h"
+
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Point {
+    int x, y;
+};
+
+// Every generation a slot can take: the handles issued for it never
+// repeat, none validates after its erase, and the slot then retires
+void generationsNeverWrap() {
+    ObjectStore<Point> store(1);
+    std::vector<Handle> issued;
+    for(uint32_t g = 0; g < Handle::generationMask; ++g) {
+        Handle h = store.create(static_cast<int>(g), 0);
+        if(h.index() != 0 || h.generation() != g)
+            break;
+        issued.push_back(h);
+        store.erase(h);
+    }
+    CHECK(issued.size() == Handle::generationMask);
+    
+    // The retired slot is not handed out again
+    Handle fresh = store.create(1, 2);
+    CHECK(fresh.index() == 1);
+    CHECK(fresh.generation() == 0);
+    for(Handle stale : issued)
+        CHECK(!store.valid(stale));
+    CHECK(store.get(fresh) && store.get(fresh)->y == 2);
+    CHECK(!store.valid(Handle{}));
+}
+
+// Dense order after swap-removes, reached only through handles
+void packedAfterErase() {
+    ObjectStore<std::string> store(8);
+    std::vector<Handle> handles;
+    for(int i = 0; i < 8; ++i)
+        handles.push_back(store.create(std::to_string(i)));
+    store.erase(handles[1]);
+    store.erase(handles[5]);
+    CHECK(store.size() == 6);
+    CHECK(!store.get(handles[1]));
+    for(int i : {0, 2, 3, 4, 6, 7})
+        CHECK(store.get(handles[i]) && *store.get(handles[i]) == std::to_string(i));
+    
+    size_t walked = 0;
+    for(const std::string& s : store) {
+        CHECK(s != "1" && s != "5");
+        ++walked;
+    }
+    CHECK(walked == 6);
+    
+    // Refill to capacity reuses the two slots with a new generation
+    Handle a = store.create("a");
+    Handle b = store.create("b");
+    CHECK(a.index() == handles[5].index() && a.generation() == 1);
+    CHECK(b.index() == handles[1].index() && b.generation() == 1);
+    CHECK(*store.get(a) == "a" && *store.get(b) == "b");
+    
+    bool full = false;
+    try {
+        store.create("overflow");
+    } catch(const std::bad_alloc&) {
+        full = true;
+    }
+    CHECK(full);
+    CHECK(store.size() == 8);
+}
+
+// The high-water mark only moves when usage passes it
+void peakUsage() {
+    MemoryPool pool(16, 8);
+    std::vector<void*> held;
+    for(int i = 0; i < 5; ++i)
+        held.push_back(pool.allocate());
+    for(int i = 0; i < 3; ++i) {
+        pool.deallocate(held.back());
+        held.pop_back();
+    }
+    CHECK(pool.used() == 2);
+    CHECK(pool.peakUsed() == 5);
+    
+    for(int i = 0; i < 3; ++i)
+        held.push_back(pool.allocate());
+    CHECK(pool.peakUsed() == 5);
+    held.push_back(pool.allocate());
+    CHECK(pool.used() == 6);
+    CHECK(pool.peakUsed() == 6);
+    for(void* p : held)
+        pool.deallocate(p);
+    CHECK(pool.used() == 0);
+}
+
+}
+
+int main() {
+    generationsNeverWrap();
+    packedAfterErase();
+    peakUsage();
+    return check::result();
+}
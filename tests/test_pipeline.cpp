@@ -0,0 +1,81 @@
+#include "check.h"
+#include "pipeline.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Enough elements for several chunks where there are cores for them
+constexpr size_t count = 1 << 19;
+
+void filterKeepsOrder() {
+    std::vector<int> numbers(count);
+    std::iota(numbers.begin(), numbers.end(), -static_cast<int>(count / 2));
+    auto isOdd = [](int n) { return n % 2 != 0; };
+    
+    std::vector<int> expected;
+    std::copy_if(numbers.begin(), numbers.end(), std::back_inserter(expected), isOdd);
+    CHECK(parallel_filter(numbers, isOdd) == expected);
+    CHECK(parallel_filter(std::vector<int>{}, isOdd).empty());
+}
+
+// No reduction, so element types with no + or int conversion filter too
+void filterNonArithmetic() {
+    std::vector<std::string> words;
+    for(size_t i = 0; i < count / 8; ++i)
+        words.push_back(std::to_string(i));
+    auto endsInSeven = [](const std::string& w) { return w.back() == '7'; };
+    
+    std::vector<std::string> expected;
+    std::copy_if(words.begin(), words.end(), std::back_inserter(expected), endsInSeven);
+    CHECK(parallel_filter(words, endsInSeven) == expected);
+    
+    std::vector<double> big{1e300, -1e300, 0.5, 3e10};
+    CHECK((parallel_filter(big, [](double d) { return d != 0.5; }) == std::vector<double>{1e300, -1e300, 3e10}));
+}
+
+void sumWithInit() {
+    std::vector<int> numbers(count);
+    std::iota(numbers.begin(), numbers.end(), 0);
+    auto all = [](int) { return true; };
+    auto widen = [](int n) { return static_cast<int64_t>(n) * n; };
+    
+    int64_t expected = 7;
+    for(int n : numbers)
+        expected += widen(n);
+    auto result = parallel_pipeline(numbers, all, widen, int64_t{7});
+    CHECK(result.total == expected);
+    CHECK(result.values.size() == numbers.size());
+}
+
+// Partials start from the identity given, not Acc{}, and init counts once
+void productWithIdentity() {
+    std::vector<double> numbers(count, 1.0);
+    numbers[3] = 2.0;
+    numbers[count - 2] = 3.0;
+    numbers[count / 2] = 0.5;
+    auto result = parallel_pipeline(numbers, [](double) { return true; }, [](double d) { return d; },
+                                    10.0, std::multiplies<>{}, 1.0);
+    CHECK(result.total == 30.0);
+    
+    auto none = parallel_pipeline(numbers, [](double) { return false; }, [](double d) { return d; },
+                                  10.0, std::multiplies<>{}, 1.0);
+    CHECK(none.total == 10.0);
+    CHECK(none.values.empty());
+}
+
+}
+
+int main() {
+    filterKeepsOrder();
+    filterNonArithmetic();
+    sumWithInit();
+    productWithIdentity();
+    return check::result();
+}
@@ -0,0 +1,98 @@
+#include "check.h"
+#include "reduce.h"
+
+#include <climits>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+// Variadic sums promote like the + they fold over
+void scalarPromotion() {
+    static_assert(std::is_same_v<decltype(sum_all(1, 2.5)), double>);
+    static_assert(std::is_same_v<decltype(sum_all(1, 2L)), long>);
+    static_assert(std::is_same_v<decltype(sum_all(1.5f, 2.5f)), float>);
+    static_assert(std::is_same_v<decltype(sum_all(char(1), short(2))), int>);
+    CHECK(sum_all(1, 2.5) == 3.5);
+    CHECK(sum_all(1, 2, 3, 4, 5) == 15);
+    CHECK(sum_all(char(100), char(100)) == 200);
+    static_assert(std::is_same_v<decltype(sum_all(char(7))), int>);
+    CHECK(sum_all(7) == 7);
+}
+
+// Each container kind takes its own path (SIMD kernel, generic block,
+// plain loop) and every one gives the same total and type
+template<typename T>
+void sameAcrossContainers(const std::vector<T>& values) {
+    using R = sum_type<T>;
+    R expected = std::accumulate(values.begin(), values.end(), R());
+    
+    std::list<T> list(values.begin(), values.end());
+    std::deque<T> deque(values.begin(), values.end());
+    std::span<const T> span(values);
+    static_assert(std::is_same_v<decltype(sum_all(values)), R>);
+    static_assert(std::is_same_v<decltype(sum_all(list)), R>);
+    static_assert(std::is_same_v<decltype(sum_all(deque)), R>);
+    CHECK(sum_all(values) == expected);
+    CHECK(sum_all(list) == expected);
+    CHECK(sum_all(deque) == expected);
+    CHECK(sum_all(span) == expected);
+}
+
+void containerDispatch() {
+    std::vector<int> ints(1000);
+    std::iota(ints.begin(), ints.end(), -300);
+    sameAcrossContainers(ints);
+    
+    // Exactly representable, so every summation order agrees
+    std::vector<double> doubles(1000);
+    for(size_t i = 0; i < doubles.size(); ++i)
+        doubles[i] = static_cast<double>(i) * 0.25;
+    sameAcrossContainers(doubles);
+    
+    std::vector<int8_t> bytes(1000, int8_t(-100));
+    static_assert(std::is_same_v<decltype(sum_all(bytes)), int>);
+    sameAcrossContainers(bytes);
+    CHECK(sum_all(bytes) == -100'000);
+    
+    int raw[] = {1, 2, 3, 4, 5};
+    CHECK(sum_all(raw) == 15);
+    unsigned short shorts[] = {60'000, 60'000};
+    static_assert(std::is_same_v<decltype(sum_all(shorts)), int>);
+    CHECK(sum_all(shorts) == 120'000);
+    
+    CHECK(sum_all(std::vector<int>{}) == 0);
+    CHECK(sum_all(std::list<double>{}) == 0.0);
+}
+
+// A lane's partial sum leaves the int range although the total fits;
+// the accumulators wrap rather than overflow
+void partialSumsWrap() {
+    const size_t lanes = sum_lanes<int>;
+    std::vector<int> values(4 * lanes + 3, 0);
+    values[0] = INT_MAX;
+    values[lanes] = INT_MAX;
+    values[2 * lanes] = -INT_MAX;
+    values[3 * lanes] = -INT_MAX;
+    values.back() = 5;
+    CHECK(sum_all(values) == 5);
+    CHECK(sum_block<int>(values.data(), values.size()) == 5);
+    CHECK(sum_all(std::list<int>(values.begin(), values.end())) == 5);
+    
+    std::vector<long long> wide{LLONG_MAX, LLONG_MAX, -LLONG_MAX, -LLONG_MAX, 3};
+    CHECK(sum_all(wide) == 3);
+}
+
+}
+
+int main() {
+    scalarPromotion();
+    containerDispatch();
+    partialSumsWrap();
+    return check::result();
+}
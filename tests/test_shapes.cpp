@@ -0,0 +1,70 @@
+#include "check.h"
+#include "shapes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace {
+
+bool near(double a, double b) {
+    return std::abs(a - b) <= 1e-12 * std::max(std::abs(a), std::abs(b));
+}
+
+// Interleaved inserts of both types, with counts that leave batchSum a
+// remainder; the batched totals match each object's own area()
+void mixedAreas() {
+    ShapeCollection<Circle, Rectangle> shapes;
+    double expected = 0;
+    double expectedCircles = 0;
+    for(int i = 0; i < 103; ++i) {
+        Circle c(0.5 + i * 0.25);
+        expected += c.area();
+        expectedCircles += c.area();
+        shapes.add(c);
+        if(i % 3 == 0) {
+            Rectangle r(1.0 + i, 2.0 - i * 0.01);
+            expected += r.area();
+            shapes.add(r);
+        }
+    }
+    CHECK(shapes.count<Circle>() == 103);
+    CHECK(shapes.count<Rectangle>() == 35);
+    CHECK(shapes.size() == 138);
+    CHECK(near(shapes.total_area(), expected));
+    
+    double visited = 0;
+    size_t seen = 0;
+    shapes.for_each([&](auto shape) {
+        visited += shape.area();
+        ++seen;
+    });
+    CHECK(seen == shapes.size());
+    CHECK(near(visited, expected));
+    
+    double circles = 0;
+    seen = 0;
+    shapes.for_each<Circle>([&](Circle c) {
+        circles += c.area();
+        ++seen;
+    });
+    CHECK(seen == 103);
+    CHECK(near(circles, expectedCircles));
+}
+
+void emptyCollection() {
+    ShapeCollection<Circle, Rectangle> shapes;
+    CHECK(shapes.size() == 0);
+    CHECK(shapes.total_area() == 0.0);
+    size_t seen = 0;
+    shapes.for_each([&](auto) { ++seen; });
+    CHECK(seen == 0);
+}
+
+}
+
+int main() {
+    mixedAreas();
+    emptyCollection();
+    return check::result();
+}
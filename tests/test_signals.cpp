@@ -0,0 +1,39 @@
+#include "check.h"
+#include "signals.h"
+
+#include <vector>
+
+namespace {
+
+void blockById() {
+    std::vector<int> calls;
+    auto signal = makeStaticSignal<int>([&](int v) { calls.push_back(v); },
+                                        [&](int v) { calls.push_back(-v); });
+    signal.emit(1);
+    signal.block(1);
+    signal.emit(2);
+    signal.block(0);
+    signal.emit(3);
+    signal.unblock(0);
+    signal.unblock(1);
+    signal.emit(4);
+    CHECK((calls == std::vector<int>{1, -1, 2, 4, -4}));
+    
+#ifdef NDEBUG
+    // Out-of-range ids assert in debug builds and are ignored otherwise
+    calls.clear();
+    signal.block(2);
+    signal.block(64);
+    signal.block(-1);
+    signal.unblock(100);
+    signal.emit(5);
+    CHECK((calls == std::vector<int>{5, -5}));
+#endif
+}
+
+}
+
+int main() {
+    blockById();
+    return check::result();
+}
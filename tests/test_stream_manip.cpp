@@ -0,0 +1,100 @@
+#include "check.h"
+#include "stream_manip.h"
+
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace {
+
+// No get area: every character goes through underflow/uflow
+class Unbuffered : public std::streambuf {
+private:
+    std::string text;
+    size_t pos = 0;
+
+protected:
+    int_type underflow() override {
+        return pos < text.size() ? traits_type::to_int_type(text[pos]) : traits_type::eof();
+    }
+    
+    int_type uflow() override {
+        return pos < text.size() ? traits_type::to_int_type(text[pos++]) : traits_type::eof();
+    }
+
+public:
+    explicit Unbuffered(std::string s) : text(std::move(s)) {}
+};
+
+// Whitespace runs of every length up to past the largest window, mixing
+// all six C-locale whitespace characters
+std::string spaced(const std::vector<std::string>& words, std::mt19937& rng) {
+    static const char blanks[] = " \t\n\v\f\r";
+    std::string text;
+    for(size_t i = 0; i < words.size(); ++i) {
+        for(size_t gap = i * 7 % 1500; gap > 0; --gap)
+            text += blanks[rng() % 6];
+        text += words[i];
+    }
+    return text;
+}
+
+std::vector<std::string> words(std::istream& in) {
+    std::vector<std::string> out;
+    std::string word;
+    while(in >> skip_whitespace() >> std::noskipws >> word)
+        out.push_back(word);
+    return out;
+}
+
+void skipsEveryRunLength() {
+    std::mt19937 rng(5);
+    std::vector<std::string> expected;
+    for(int i = 0; i < 400; ++i)
+        expected.push_back(std::to_string(i) + "w");
+    std::string text = spaced(expected, rng) + "  \t\n";
+    
+    std::istringstream buffered(text);
+    CHECK(words(buffered) == expected);
+    CHECK(buffered.eof());
+    
+    Unbuffered raw(text);
+    std::istream unbuffered(&raw);
+    CHECK(words(unbuffered) == expected);
+    CHECK(unbuffered.eof());
+}
+
+void stopsAtFirstNonSpace() {
+    std::istringstream in(std::string(5000, ' ') + "x y");
+    in >> skip_whitespace();
+    CHECK(in.good());
+    CHECK(in.get() == 'x');
+    CHECK(in.get() == ' ');
+    
+    std::istringstream empty("");
+    empty >> skip_whitespace();
+    CHECK(empty.eof() && !empty.bad());
+}
+
+// Every start offset, so each kernel's vector loop and tail see the end
+void findNonSpace() {
+    std::string text = std::string(1000, '\t') + "!";
+    const char* bang = text.data() + text.size() - 1;
+    bool found = true;
+    for(size_t from = 0; from < text.size(); ++from) {
+        found = found && find_non_space(text.data() + from, bang + 1) == bang;
+        found = found && find_non_space(text.data() + from, bang) == bang;
+    }
+    CHECK(found);
+}
+
+}
+
+int main() {
+    skipsEveryRunLength();
+    stopsAtFirstNonSpace();
+    findNonSpace();
+    return check::result();
+}
@@ -0,0 +1,150 @@
+#include "check.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+bool rejected(const ThreadPool::Options& options) {
+    try {
+        ThreadPool pool(options);
+    } catch(const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+void spinOptionsValidated() {
+    ThreadPool::Options options;
+    options.threads = 2;
+    options.spinLimit = 64;
+    options.spinMin = 128;
+    CHECK(rejected(options));
+    options.spinMin = 0;
+    CHECK(rejected(options));
+    options.spinMin = 64;
+    CHECK(!rejected(options));
+    
+    // spinMin is unused with spinning off
+    options.spinLimit = 0;
+    options.spinMin = 1000;
+    CHECK(!rejected(options));
+}
+
+// Polls until the pool has shrunk to size or the deadline passes
+bool shrinksTo(const ThreadPool& pool, size_t size, std::chrono::milliseconds deadline) {
+    auto until = std::chrono::steady_clock::now() + deadline;
+    while(pool.size() != size && std::chrono::steady_clock::now() < until)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    return pool.size() == size;
+}
+
+// The whole backlog is queued long before growAfter, so only the workers
+// taking tasks off it can see it last and add more workers. Once idle for
+// retireAfter the extra workers go again.
+void elasticGrowsAndRetires() {
+    using namespace std::chrono_literals;
+    ThreadPool::Options options;
+    options.threads = 1;
+    options.maxThreads = 4;
+    options.backlogPerWorker = 1;
+    options.growAfter = 30ms;
+    options.retireAfter = 50ms;
+    ThreadPool pool(options);
+    
+    std::atomic<size_t> largest{0};
+    std::vector<std::future<int>> results;
+    for(int i = 0; i < 40; ++i) {
+        results.push_back(pool.enqueue([&pool, &largest, i] {
+            std::this_thread::sleep_for(10ms);
+            size_t now = pool.size();
+            size_t seen = largest.load();
+            while(now > seen && !largest.compare_exchange_weak(seen, now)) {}
+            return i;
+        }));
+    }
+    for(int i = 0; i < 40; ++i)
+        CHECK(results[i].get() == i);
+    CHECK(largest.load() > 1);
+    CHECK(largest.load() <= 4);
+    CHECK(shrinksTo(pool, 1, 2000ms));
+    
+    // Still usable at its base size
+    CHECK(pool.enqueue([] { return 7; }).get() == 7);
+}
+
+// Spinning workers, with bursts both back to back and after the workers
+// have given up spinning and parked
+void spinningWorkersComplete() {
+    using namespace std::chrono_literals;
+    for(size_t maxThreads : {size_t(0), size_t(4)}) {
+        ThreadPool::Options options;
+        options.threads = 2;
+        options.spinLimit = 2000;
+        options.spinMin = 16;
+        options.maxThreads = maxThreads;
+        options.growAfter = 100us;
+        options.retireAfter = 20ms;
+        ThreadPool pool(options);
+        
+        long long expected = 0, total = 0;
+        for(int burst = 0; burst < 20; ++burst) {
+            std::vector<std::future<int>> results;
+            for(int i = 0; i < 500; ++i) {
+                results.push_back(pool.enqueue([i, burst] { return i * burst; }));
+                expected += i * burst;
+            }
+            for(auto& r : results)
+                total += r.get();
+            if(burst % 5 == 4)
+                std::this_thread::sleep_for(30ms);
+        }
+        CHECK(total == expected);
+    }
+}
+
+#if defined(__linux__)
+void pinnedWorkersRun() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+    int cpu = 0;
+    while(cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &allowed))
+        ++cpu;
+    
+    ThreadPool::Options options;
+    options.threads = 2;
+    options.cpus = {cpu};
+    ThreadPool pool(options);
+    std::vector<std::future<int>> results;
+    for(int i = 0; i < 8; ++i)
+        results.push_back(pool.enqueue([] { return sched_getcpu(); }));
+    for(auto& r : results)
+        CHECK(r.get() == cpu);
+    
+    const ThreadPool& view = pool;
+    CHECK(view.size() == 2);
+    CHECK(view.affinityFailures() == 0);
+    
+    options.cpus = {-1};
+    CHECK(rejected(options));
+}
+#endif
+
+}
+
+int main() {
+    spinOptionsValidated();
+    elasticGrowsAndRetires();
+    spinningWorkersComplete();
+#if defined(__linux__)
+    pinnedWorkersRun();
+#endif
+    return check::result();
+}
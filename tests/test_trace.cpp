@@ -0,0 +1,76 @@
+#include "check.h"
+#include "trace.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+// Threads known to the exporter: one thread_name record per buffer
+size_t exportedThreads() {
+    const char* path = "test_trace.json";
+    if(!trace::writeChrome(path))
+        return 0;
+    std::ifstream in(path);
+    std::stringstream text;
+    text << in.rdbuf();
+    std::remove(path);
+    
+    std::string s = text.str();
+    size_t count = 0;
+    for(size_t pos = 0; (pos = s.find("\"thread_name\"", pos)) != std::string::npos; ++pos)
+        ++count;
+    return count;
+}
+
+void shortLivedThreads(int threads, bool record) {
+    for(int i = 0; i < threads; ++i) {
+        std::thread([record] {
+            trace::setThreadName("short-lived");
+            if(record)
+                trace::instant("Test::event");
+        }).join();
+    }
+}
+
+// Naming a thread while not recording takes no buffer
+void namingDoesNotAttach() {
+    shortLivedThreads(50, false);
+    CHECK(exportedThreads() == 0);
+}
+
+// Exited threads' events survive until the next start(); after it their
+// buffers serve new threads instead of piling up
+void exitedBuffersAreRecycled() {
+    trace::start();
+    shortLivedThreads(20, true);
+    trace::stop();
+    CHECK(trace::eventCount() == 20);
+    size_t afterFirst = exportedThreads();
+    CHECK(afterFirst == 20);
+    
+    for(int session = 0; session < 5; ++session) {
+        trace::start();
+        shortLivedThreads(20, true);
+        trace::stop();
+        CHECK(trace::eventCount() == 20);
+    }
+    CHECK(exportedThreads() == afterFirst);
+    
+    // Threads that only name themselves never attach, recording or not
+    trace::start();
+    shortLivedThreads(100, false);
+    trace::stop();
+    CHECK(exportedThreads() == afterFirst);
+}
+
+}
+
+int main() {
+    namingDoesNotAttach();
+    exitedBuffersAreRecycled();
+    return check::result();
+}
@@ -0,0 +1,50 @@
+#include "check.h"
+#include "vector_expr.h"
+
+#include <stdexcept>
+
+namespace {
+
+void sumsChains() {
+    const size_t n = 1003;
+    Vector a(n), b(n), c(n), out(n);
+    for(size_t i = 0; i < n; ++i) {
+        a[i] = static_cast<double>(i);
+        b[i] = 0.5 * static_cast<double>(i);
+        c[i] = -2.0;
+    }
+    out = a + b + c;
+    bool same = true;
+    for(size_t i = 0; i < n; ++i)
+        same = same && out[i] == (a[i] + b[i]) + c[i];
+    CHECK(same);
+}
+
+// Size mismatches throw in every build instead of reading or writing past
+// the shorter vector
+void rejectsMismatchedSizes() {
+    Vector a(100), b(100), shorter(50), out(100);
+    bool threw = false;
+    try {
+        shorter = a + b;
+    } catch(const std::length_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    
+    threw = false;
+    try {
+        out = a + shorter;
+    } catch(const std::length_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+}
+
+int main() {
+    sumsChains();
+    rejectsMismatchedSizes();
+    return check::result();
+}